@@ -92,6 +92,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtLegendData \
         QwtLegendLabel \
         QwtPointMapper \
+        QwtPointIndex \
         QwtMatrixRasterData \
         QwtOHLCSample \
         QwtPlot \
@@ -112,6 +113,8 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtPlotMultiBarChart \
         QwtPlotPanner \
         QwtPlotPicker \
+        QwtPlotProfileCollector \
+        QwtPlotProfiler \
         QwtPlotRasterItem \
         QwtPlotRenderer \
         QwtPlotRescaler \
@@ -138,6 +141,8 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtSetSeriesData \
         QwtSyntheticPointData \
         QwtPointArrayData \
+        QwtPyramidPointData \
+        QwtCircularPointData \
         QwtTradingChartData \
         QwtCPointerData
 }
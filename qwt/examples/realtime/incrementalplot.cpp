@@ -7,23 +7,16 @@
 #include <qwt_plot_directpainter.h>
 #include <qwt_painter.h>
 
-class CurveData: public QwtArraySeriesData<QPointF>
+class CurveData: public QwtPointSeriesData
 {
 public:
     CurveData()
     {
     }
 
-    virtual QRectF boundingRect() const QWT_OVERRIDE
-    {
-        if ( d_boundingRect.width() < 0.0 )
-            d_boundingRect = qwtBoundingRect( *this );
-
-        return d_boundingRect;
-    }
-
     inline void append( const QPointF &point )
     {
+        // the bounding rectangle is extended by the appended points
         d_samples += point;
     }
 
@@ -31,7 +24,7 @@ public:
     {
         d_samples.clear();
         d_samples.squeeze();
-        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+        invalidateBoundingRect();
     }
 };
 
@@ -11,21 +11,155 @@
 #include "qwt_text.h"
 #include "qwt_painter.h"
 #include "qwt_scale_map.h"
+#include "qwt_transform.h"
 #include "qwt_math.h"
 
 #include <qpainter.h>
 #include <qpalette.h>
 #include <qmap.h>
+#include <qhash.h>
 #include <qlist.h>
+#include <qvector.h>
 #include <qlocale.h>
+#include <qmutex.h>
+#include <qnumeric.h>
+#include <qcoreapplication.h>
+
+#include <algorithm>
+
+static void qwtClearSharedLabelCache();
+
+namespace
+{
+    /*
+      Tick labels, that have been measured by any scale draw.
+      Axes with the same font share the layout of their labels.
+
+      The labels hold fonts, so the cache is cleared, when
+      the application object is destroyed.
+     */
+    class SharedLabelCache
+    {
+    public:
+        enum { MaxSize = 2000 };
+
+        SharedLabelCache():
+            isRegistered( false )
+        {
+        }
+
+        void clear()
+        {
+            QMutexLocker locker( &mutex );
+
+            labels.clear();
+            isRegistered = false;
+        }
+
+        QwtText measuredLabel( const QwtText &label, const QFont &font )
+        {
+            const QString key = label.text()
+                + QChar( 0 ) + label.usedFont( font ).key();
+
+            QMutexLocker locker( &mutex );
+
+            QHash<QString, QwtText>::const_iterator it = labels.constFind( key );
+            if ( it != labels.constEnd() && it.value() == label )
+                return it.value();
+
+            locker.unlock();
+
+            ( void )label.textSize( font ); // initialize the internal cache
+
+            locker.relock();
+
+            if ( !isRegistered )
+            {
+                if ( QCoreApplication::instance() == NULL )
+                    return label;
+
+                qAddPostRoutine( qwtClearSharedLabelCache );
+                isRegistered = true;
+            }
+
+            if ( labels.size() >= MaxSize )
+                labels.clear();
+
+            labels.insert( key, label );
+
+            return label;
+        }
+
+    private:
+        QMutex mutex;
+        QHash<QString, QwtText> labels;
+
+        bool isRegistered;
+    };
+
+    class LabelCacheEntry
+    {
+    public:
+        QwtText label;
+
+        // labels of a previous scale division need to be validated
+        uint scaleDivId;
+
+        // for finding the least recently used labels
+        uint lastUse;
+    };
+}
+
+static SharedLabelCache &qwtSharedLabelCache()
+{
+    static SharedLabelCache cache;
+    return cache;
+}
+
+static void qwtClearSharedLabelCache()
+{
+    qwtSharedLabelCache().clear();
+}
+
+static bool qwtIsLinearDivision( const QwtScaleMap &map,
+    const QList<double> &ticks )
+{
+    const QwtTransform *transform = map.transformation();
+    if ( transform && dynamic_cast< const QwtNullTransform * >( transform ) == NULL )
+        return false;
+
+    // f.e. dates with steps of months are not equidistant
+
+    const double step = ticks[1] - ticks[0];
+    for ( int i = 2; i < ticks.count(); i++ )
+    {
+        if ( qAbs( ticks[i] - ticks[i - 1] - step ) > 1e-6 * qAbs( step ) )
+            return false;
+    }
+
+    return true;
+}
+
+static QwtText qwtLabel( const QwtText &text, const QFont &font )
+{
+    QwtText lbl = text;
+    lbl.setRenderFlags( 0 );
+    lbl.setLayoutAttribute( QwtText::MinimumLayout );
+
+    return qwtSharedLabelCache().measuredLabel( lbl, font );
+}
 
 class QwtAbstractScaleDraw::PrivateData
 {
 public:
+    enum { MaxLabelCacheSize = 500 };
+
     PrivateData():
         spacing( 4.0 ),
         penWidthF( 0.0 ),
-        minExtent( 0.0 )
+        minExtent( 0.0 ),
+        scaleDivId( 0 ),
+        labelUseCount( 0 )
     {
         components = QwtAbstractScaleDraw::Backbone
             | QwtAbstractScaleDraw::Ticks
@@ -47,7 +181,10 @@ public:
 
     double minExtent;
 
-    QMap<double, QwtText> labelCache;
+    uint scaleDivId;
+    uint labelUseCount;
+
+    QMap<double, LabelCacheEntry> labelCache;
 };
 
 /*!
@@ -105,7 +242,9 @@ void QwtAbstractScaleDraw::setScaleDiv( const QwtScaleDiv &scaleDiv )
 {
     d_data->scaleDiv = scaleDiv;
     d_data->map.setScaleInterval( scaleDiv.lowerBound(), scaleDiv.upperBound() );
-    d_data->labelCache.clear();
+
+    // the cached labels are validated, when being used the next time
+    d_data->scaleDivId++;
 }
 
 /*!
@@ -192,6 +331,21 @@ void QwtAbstractScaleDraw::draw( QPainter *painter,
                 drawLabel( painter, v );
         }
 
+        const int n = majorTicks.count();
+        if ( n >= 2 && qwtIsLinearDivision( d_data->map, majorTicks ) )
+        {
+            // Lay out the labels of the ticks, that will probably appear
+            // next, when the scale is scrolled
+
+            const double v1 = 2 * majorTicks[0] - majorTicks[1];
+            if ( qIsFinite( v1 ) )
+                ( void )tickLabel( painter->font(), v1 );
+
+            const double v2 = 2 * majorTicks[n - 1] - majorTicks[n - 2];
+            if ( qIsFinite( v2 ) )
+                ( void )tickLabel( painter->font(), v2 );
+        }
+
         painter->restore();
     }
 
@@ -386,6 +540,13 @@ QwtText QwtAbstractScaleDraw::label( double value ) const
    calculation of the label sizes might be slow (really slow
    for rich text in Qt4), so it's necessary to cache the labels.
 
+   The cache keeps the least recently used labels, when a new
+   QwtScaleDiv is set. As label() might depend on the scale division
+   a cached label is compared with label() before it is reused, but
+   its layout doesn't need to be calculated again. Labels with the
+   same text and font share their layout with the labels of all
+   other scale draws.
+
    \param font Font
    \param value Value
 
@@ -394,25 +555,61 @@ QwtText QwtAbstractScaleDraw::label( double value ) const
 const QwtText &QwtAbstractScaleDraw::tickLabel(
     const QFont &font, double value ) const
 {
-    QMap<double, QwtText>::const_iterator it1 = d_data->labelCache.constFind( value );
-    if ( it1 != d_data->labelCache.constEnd() )
-        return *it1;
+    QMap<double, LabelCacheEntry> &cache = d_data->labelCache;
 
-    QwtText lbl = label( value );
-    lbl.setRenderFlags( 0 );
-    lbl.setLayoutAttribute( QwtText::MinimumLayout );
+    QMap<double, LabelCacheEntry>::iterator it = cache.find( value );
+    if ( it == cache.end() )
+    {
+        if ( cache.size() >= PrivateData::MaxLabelCacheSize )
+        {
+            // remove the older half of the labels
+
+            QVector<uint> useCounts;
+            useCounts.reserve( cache.size() );
+
+            for ( it = cache.begin(); it != cache.end(); ++it )
+                useCounts += it.value().lastUse;
+
+            QVector<uint>::iterator median =
+                useCounts.begin() + useCounts.size() / 2;
+            std::nth_element( useCounts.begin(), median, useCounts.end() );
 
-    ( void )lbl.textSize( font ); // initialize the internal cache
+            for ( it = cache.begin(); it != cache.end(); )
+            {
+                if ( it.value().lastUse < *median )
+                    it = cache.erase( it );
+                else
+                    ++it;
+            }
+        }
+
+        LabelCacheEntry entry;
+        entry.label = qwtLabel( label( value ), font );
+        entry.scaleDivId = d_data->scaleDivId;
+
+        it = cache.insert( value, entry );
+    }
+    else if ( it.value().scaleDivId != d_data->scaleDivId )
+    {
+        QwtText lbl = label( value );
+        lbl.setRenderFlags( 0 );
+
+        if ( lbl != it.value().label )
+            it.value().label = qwtLabel( lbl, font );
+
+        it.value().scaleDivId = d_data->scaleDivId;
+    }
 
-    QMap<double, QwtText>::iterator it2 = d_data->labelCache.insert( value, lbl );
-    return *it2;
+    it.value().lastUse = ++d_data->labelUseCount;
+    return it.value().label;
 }
 
 /*!
    Invalidate the cache used by tickLabel()
 
-   The cache is invalidated, when a new QwtScaleDiv is set. If
-   the labels need to be changed. while the same QwtScaleDiv is set,
+   Labels that have been cached for a previous QwtScaleDiv are
+   validated against label(), when a new QwtScaleDiv is set. If
+   the labels need to be changed, while the same QwtScaleDiv is set,
    invalidateCache() needs to be called manually.
 */
 void QwtAbstractScaleDraw::invalidateCache()
@@ -0,0 +1,324 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_circular_point_data.h"
+
+#include <qatomic.h>
+#include <string.h>
+
+/*
+    The positions are counters of appended/removed samples, that
+    are allowed to wrap around. As the capacity is a power of 2
+    the slot of a position is found by masking its lower bits.
+ */
+
+static inline uint qwtLoadAcquire( const QAtomicInt &value )
+{
+#if QT_VERSION >= 0x050000
+    return static_cast<uint>( value.loadAcquire() );
+#else
+    return static_cast<uint>(
+        const_cast<QAtomicInt &>( value ).fetchAndAddAcquire( 0 ) );
+#endif
+}
+
+static inline void qwtStoreRelease( QAtomicInt &value, uint v )
+{
+#if QT_VERSION >= 0x050000
+    value.storeRelease( static_cast<int>( v ) );
+#else
+    value.fetchAndStoreRelease( static_cast<int>( v ) );
+#endif
+}
+
+class QwtCircularPointData::PrivateData
+{
+public:
+    PrivateData( int size ):
+        head( 0 ),
+        tail( 0 ),
+        snapshotHead( 0 ),
+        snapshotTail( 0 ),
+        isEmpty( true ),
+        isDirty( false )
+    {
+        capacity = 1;
+        while ( capacity < static_cast<uint>( size ) )
+            capacity <<= 1;
+
+        mask = capacity - 1;
+        historySize = qMax( capacity / 2, 1u );
+
+        buffer = new QPointF[ capacity ];
+    }
+
+    ~PrivateData()
+    {
+        delete [] buffer;
+    }
+
+    inline const QPointF &at( uint pos ) const
+    {
+        return buffer[ pos & mask ];
+    }
+
+    void extend( const QPointF &pos )
+    {
+        if ( isEmpty )
+        {
+            xMin = xMax = pos.x();
+            yMin = yMax = pos.y();
+            isEmpty = false;
+        }
+        else
+        {
+            xMin = qMin( xMin, pos.x() );
+            xMax = qMax( xMax, pos.x() );
+            yMin = qMin( yMin, pos.y() );
+            yMax = qMax( yMax, pos.y() );
+        }
+    }
+
+    inline bool isOnBorder( const QPointF &pos ) const
+    {
+        return pos.x() <= xMin || pos.x() >= xMax
+            || pos.y() <= yMin || pos.y() >= yMax;
+    }
+
+    void recalculate()
+    {
+        isEmpty = true;
+        for ( uint i = snapshotTail; i != snapshotHead; i++ )
+            extend( at( i ) );
+
+        isDirty = false;
+    }
+
+    QPointF *buffer;
+    uint capacity;
+    uint mask;
+    uint historySize;
+
+    // written by the producer only
+    QAtomicInt head;
+
+    // written by the consumer only
+    QAtomicInt tail;
+
+    // the snapshot, only accessed by the consumer
+    uint snapshotHead;
+    uint snapshotTail;
+
+    bool isEmpty;
+    bool isDirty;
+
+    double xMin, xMax;
+    double yMin, yMax;
+};
+
+/*!
+  \brief Constructor
+
+  \param capacity Number of samples, that can be stored in the buffer.
+                  It is rounded up to the next power of 2.
+
+  The history size is initialized to half of the capacity, leaving the other
+  half for the samples that are appended in between two snapshots.
+
+  \sa setHistorySize()
+ */
+QwtCircularPointData::QwtCircularPointData( int capacity )
+{
+    d_data = new PrivateData( qMax( capacity, 2 ) );
+}
+
+//! Destructor
+QwtCircularPointData::~QwtCircularPointData()
+{
+    delete d_data;
+}
+
+//! \return Number of samples, that can be stored in the buffer
+int QwtCircularPointData::capacity() const
+{
+    return static_cast<int>( d_data->capacity );
+}
+
+/*!
+  \brief Set the maximum number of samples of a snapshot
+
+  When there are more samples, updateSnapshot() removes the oldest ones.
+  The difference between capacity() and historySize() is the number of
+  samples, that can be appended in between two snapshots without
+  dropping samples.
+
+  \param size History size, bounded to [1, capacity()]
+  \note Needs to be called from the consumer thread
+  \sa historySize(), updateSnapshot()
+ */
+void QwtCircularPointData::setHistorySize( int size )
+{
+    size = qBound( 1, size, capacity() );
+    d_data->historySize = static_cast<uint>( size );
+}
+
+/*!
+  \return Maximum number of samples of a snapshot
+  \sa setHistorySize()
+ */
+int QwtCircularPointData::historySize() const
+{
+    return static_cast<int>( d_data->historySize );
+}
+
+/*!
+  \brief Append a sample
+
+  Appending is wait-free and must not be called from more
+  than one thread at the same time.
+
+  \param sample Sample to be appended
+  \return false, when the buffer is full and the sample has been dropped
+ */
+bool QwtCircularPointData::append( const QPointF &sample )
+{
+    const uint head = qwtLoadAcquire( d_data->head );
+    const uint tail = qwtLoadAcquire( d_data->tail );
+
+    if ( head - tail >= d_data->capacity )
+        return false;
+
+    d_data->buffer[ head & d_data->mask ] = sample;
+    qwtStoreRelease( d_data->head, head + 1 );
+
+    return true;
+}
+
+/*!
+  \brief Update the snapshot of readable samples
+
+  Takes over the samples, that have been appended since the last
+  snapshot, and removes the oldest samples exceeding historySize().
+  The slots of the removed samples are released to the producer.
+
+  \note Needs to be called from the consumer thread, but not while
+        the series is painted.
+ */
+void QwtCircularPointData::updateSnapshot()
+{
+    PrivateData *d = d_data;
+
+    const uint head = qwtLoadAcquire( d->head );
+
+    if ( !d->isDirty )
+    {
+        for ( uint i = d->snapshotHead; i != head; i++ )
+            d->extend( d->at( i ) );
+    }
+
+    uint tail = d->snapshotTail;
+    if ( head - tail > d->historySize )
+    {
+        const uint newTail = head - d->historySize;
+
+        if ( !d->isDirty )
+        {
+            for ( uint i = tail; i != newTail; i++ )
+            {
+                if ( d->isOnBorder( d->at( i ) ) )
+                {
+                    d->isDirty = true;
+                    break;
+                }
+            }
+        }
+
+        tail = newTail;
+        qwtStoreRelease( d->tail, tail );
+    }
+
+    d->snapshotHead = head;
+    d->snapshotTail = tail;
+}
+
+/*!
+  \brief Remove all samples of the snapshot
+
+  Samples, that have been appended after the last call
+  of updateSnapshot() are not affected.
+
+  \note Needs to be called from the consumer thread
+ */
+void QwtCircularPointData::clear()
+{
+    d_data->snapshotTail = d_data->snapshotHead;
+    qwtStoreRelease( d_data->tail, d_data->snapshotTail );
+
+    d_data->isEmpty = true;
+    d_data->isDirty = false;
+}
+
+//! \return Number of samples of the snapshot
+size_t QwtCircularPointData::size() const
+{
+    return d_data->snapshotHead - d_data->snapshotTail;
+}
+
+/*!
+  \return Sample of the snapshot at a specific index
+  \param index Index, where 0 is the oldest sample
+ */
+QPointF QwtCircularPointData::sample( size_t index ) const
+{
+    return d_data->at( d_data->snapshotTail + static_cast<uint>( index ) );
+}
+
+/*!
+  \brief Copy a block of samples from the snapshot
+
+  The samples are copied in at most 2 chunks, as the block might
+  wrap around the end of the buffer.
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Array of at least count samples
+ */
+void QwtCircularPointData::sampleBlock( size_t from,
+    size_t count, QPointF *samples ) const
+{
+    const uint pos = ( d_data->snapshotTail
+        + static_cast<uint>( from ) ) & d_data->mask;
+
+    const size_t n1 = qMin( count,
+        static_cast<size_t>( d_data->capacity - pos ) );
+
+    ::memcpy( samples, d_data->buffer + pos, n1 * sizeof( QPointF ) );
+    ::memcpy( samples + n1, d_data->buffer, ( count - n1 ) * sizeof( QPointF ) );
+}
+
+/*!
+  \brief Calculate the bounding rectangle of the snapshot
+
+  The rectangle is maintained incrementally by updateSnapshot()
+  and has to be recalculated only, when a sample on its border
+  has been removed.
+
+  \return Bounding rectangle
+ */
+QRectF QwtCircularPointData::boundingRect() const
+{
+    if ( d_data->isDirty )
+        d_data->recalculate();
+
+    if ( d_data->isEmpty )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    return QRectF( d_data->xMin, d_data->yMin,
+        d_data->xMax - d_data->xMin, d_data->yMax - d_data->yMin );
+}
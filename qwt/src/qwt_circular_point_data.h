@@ -0,0 +1,100 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_CIRCULAR_POINT_DATA_H
+#define QWT_CIRCULAR_POINT_DATA_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+/*!
+  \brief Series of points stored in a lock-free ring buffer
+
+  QwtCircularPointData is intended for displaying a signal, that is
+  collected in a different thread ( f.e. by a QwtSamplingThread ).
+  It is a single producer/single consumer ring buffer of
+  fixed capacity, where the producer thread appends samples without
+  waiting for the GUI thread and vice versa.
+
+  - append()\n
+    Called from the producer thread only. Appending a sample never blocks.
+    When the buffer is full the sample is dropped.
+
+  - updateSnapshot()\n
+    Called from the GUI thread only - usually right before QwtPlot::replot().
+    It takes over all samples, that have been appended since the last
+    snapshot, and removes the oldest samples, when there are more than
+    historySize() samples. All other methods of the QwtSeriesData API
+    operate on this snapshot, so that the painting code always sees
+    a consistent set of samples.
+
+  The bounding rectangle of the snapshot is extended by the new samples
+  only. It is recalculated when one of the removed samples was on the border
+  of the bounding rectangle.
+
+  \par Example
+  \code
+    class SamplingThread: public QwtSamplingThread
+    {
+    public:
+        SamplingThread( QwtCircularPointData *data ):
+            d_data( data )
+        {
+        }
+
+    protected:
+        virtual void sample( double elapsed )
+        {
+            d_data->append( QPointF( elapsed, readValue() ) );
+        }
+
+    private:
+        QwtCircularPointData *d_data;
+    };
+
+    // GUI thread, f.e. in QObject::timerEvent()
+    data->updateSnapshot();
+    plot->replot();
+  \endcode
+
+  \note The curve takes ownership of its data. So the data object
+        needs to be deleted after the producer thread has been stopped.
+*/
+class QWT_EXPORT QwtCircularPointData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtCircularPointData( int capacity );
+    virtual ~QwtCircularPointData();
+
+    int capacity() const;
+
+    void setHistorySize( int );
+    int historySize() const;
+
+    bool append( const QPointF & );
+
+    void updateSnapshot();
+    void clear();
+
+    virtual size_t size() const QWT_OVERRIDE;
+    virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
+
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+
+    virtual QRectF boundingRect() const QWT_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(QwtCircularPointData)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -11,6 +11,13 @@
 #include "qwt_interval.h"
 
 #include <qvector.h>
+#include <qnumeric.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+    ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define QWT_USE_SSE2 1
+#include <emmintrin.h>
+#endif
 
 #if (__GNUC__ * 100 + __GNUC_MINOR__) >= 408
 
@@ -85,6 +92,9 @@ public:
     void insert( double pos, const QColor &color );
     QRgb rgb( QwtLinearColorMap::Mode, double pos ) const;
 
+    void rgbRow( QwtLinearColorMap::Mode, double min, double width,
+        const double *values, QRgb *rgbs, int count ) const;
+
     QVector<double> stops() const;
 
 private:
@@ -142,6 +152,8 @@ private:
     };
 
     inline int findUpper( double pos ) const;
+    inline QRgb interpolated( const ColorStop &, double pos ) const;
+
     QVector<ColorStop> d_stops;
     bool d_doAlpha;
 };
@@ -215,6 +227,33 @@ inline int QwtLinearColorMap::ColorStops::findUpper( double pos ) const
     return index;
 }
 
+inline QRgb QwtLinearColorMap::ColorStops::interpolated(
+    const ColorStop &s1, double pos ) const
+{
+    const double ratio = ( pos - s1.pos ) / ( s1.posStep );
+
+    const int r = int( s1.r0 + ratio * s1.rStep );
+    const int g = int( s1.g0 + ratio * s1.gStep );
+    const int b = int( s1.b0 + ratio * s1.bStep );
+
+    if ( d_doAlpha )
+    {
+        if ( s1.aStep )
+        {
+            const int a = int( s1.a0 + ratio * s1.aStep );
+            return qRgba( r, g, b, a );
+        }
+        else
+        {
+            return qRgba( r, g, b, s1.a );
+        }
+    }
+    else
+    {
+        return qRgb( r, g, b );
+    }
+}
+
 inline QRgb QwtLinearColorMap::ColorStops::rgb(
     QwtLinearColorMap::Mode mode, double pos ) const
 {
@@ -225,38 +264,111 @@ inline QRgb QwtLinearColorMap::ColorStops::rgb(
 
     const int index = findUpper( pos );
     if ( mode == FixedColors )
-    {
         return d_stops[index-1].rgb;
-    }
-    else
-    {
-        const ColorStop &s1 = d_stops[index-1];
 
-        const double ratio = ( pos - s1.pos ) / ( s1.posStep );
+    return interpolated( d_stops[index-1], pos );
+}
+
+void QwtLinearColorMap::ColorStops::rgbRow(
+    QwtLinearColorMap::Mode mode, double min, double width,
+    const double *values, QRgb *rgbs, int count ) const
+{
+    const ColorStop *stops = d_stops.constData();
+
+    const QRgb rgbFirst = stops[0].rgb;
+    const QRgb rgbLast = stops[ d_stops.size() - 1 ].rgb;
 
-        const int r = int( s1.r0 + ratio * s1.rStep );
-        const int g = int( s1.g0 + ratio * s1.gStep );
-        const int b = int( s1.b0 + ratio * s1.bStep );
+    /*
+        Neighboured values are usually between the same
+        stops, so we try the stops of the previous value first,
+        before doing the binary search.
+     */
+    int index = 1;
 
-        if ( d_doAlpha )
+    for ( int i = 0; i < count; i++ )
+    {
+        const double value = values[i];
+        if ( qIsNaN( value ) )
         {
-            if ( s1.aStep )
-            {
-                const int a = int( s1.a0 + ratio * s1.aStep );
-                return qRgba( r, g, b, a );
-            }
-            else
-            {
-                return qRgba( r, g, b, s1.a );
-            }
+            rgbs[i] = 0u;
+            continue;
+        }
+
+        const double pos = ( value - min ) / width;
+
+        if ( pos <= 0.0 )
+        {
+            rgbs[i] = rgbFirst;
+        }
+        else if ( pos >= 1.0 )
+        {
+            rgbs[i] = rgbLast;
         }
         else
         {
-            return qRgb( r, g, b );
+            if ( !( stops[index - 1].pos <= pos && pos < stops[index].pos ) )
+                index = findUpper( pos );
+
+            if ( mode == FixedColors )
+                rgbs[i] = stops[index - 1].rgb;
+            else
+                rgbs[i] = interpolated( stops[index - 1], pos );
         }
     }
 }
 
+static inline uint qwtColorIndex( double value, double min,
+    double max, double width, double maxIndex, double offset )
+{
+    if ( value >= max )
+        return static_cast<uint>( maxIndex );
+
+    const double v = ( maxIndex * ( value - min ) ) / width + offset;
+
+    // values below min and NaN values are mapped to 0
+    return ( v > 0.0 ) ? static_cast<uint>( v ) : 0u;
+}
+
+static void qwtColorIndexes( const double *values, uint *indexes, int count,
+    double min, double max, double width, double maxIndex, double offset )
+{
+    int i = 0;
+
+#if QWT_USE_SSE2
+    const __m128d vMin = _mm_set1_pd( min );
+    const __m128d vMax = _mm_set1_pd( max );
+    const __m128d vWidth = _mm_set1_pd( width );
+    const __m128d vMaxIndex = _mm_set1_pd( maxIndex );
+    const __m128d vOffset = _mm_set1_pd( offset );
+    const __m128d vZero = _mm_setzero_pd();
+
+    for ( ; i + 1 < count; i += 2 )
+    {
+        const __m128d v = _mm_loadu_pd( values + i );
+
+        __m128d idx = _mm_div_pd(
+            _mm_mul_pd( vMaxIndex, _mm_sub_pd( v, vMin ) ), vWidth );
+        idx = _mm_add_pd( idx, vOffset );
+
+        // the second operand is returned for NaN values
+        idx = _mm_max_pd( idx, vZero );
+
+        const __m128d isMax = _mm_cmpge_pd( v, vMax );
+        idx = _mm_or_pd( _mm_and_pd( isMax, vMaxIndex ),
+            _mm_andnot_pd( isMax, idx ) );
+
+        _mm_storel_epi64( reinterpret_cast<__m128i *>( indexes + i ),
+            _mm_cvttpd_epi32( idx ) );
+    }
+#endif
+
+    for ( ; i < count; i++ )
+    {
+        indexes[i] = qwtColorIndex( values[i],
+            min, max, width, maxIndex, offset );
+    }
+}
+
 /*!
    Constructor
    \param format Format of the color map
@@ -324,6 +436,52 @@ uint QwtColorMap::colorIndex( int numColors,
 #pragma GCC pop_options
 #endif
 
+/*!
+  \brief Map an array of values into RGB values
+
+  The default implementation calls rgb() for each value.
+  Color maps with a faster implementation for many values
+  might reimplement rgbRow().
+
+  \param interval Range for all values
+  \param values Values to map into RGB values
+  \param rgbs Array, where the RGB values are stored
+  \param count Number of values
+
+  \note NaN values are mapped to a transparent 0u
+  \sa rgb(), colorIndexRow()
+*/
+void QwtColorMap::rgbRow( const QwtInterval &interval,
+    const double *values, QRgb *rgbs, int count ) const
+{
+    for ( int i = 0; i < count; i++ )
+        rgbs[i] = qIsNaN( values[i] ) ? 0u : rgb( interval, values[i] );
+}
+
+/*!
+  \brief Map an array of values into color indexes
+
+  The default implementation calls colorIndex() for each value.
+
+  \param numColors Number of colors
+  \param interval Range for all values
+  \param values Values to map into color indexes
+  \param indexes Array, where the color indexes are stored
+  \param count Number of values
+
+  \note NaN values are mapped to 0
+  \sa colorIndex(), rgbRow()
+*/
+void QwtColorMap::colorIndexRow( int numColors, const QwtInterval &interval,
+    const double *values, uint *indexes, int count ) const
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        indexes[i] = qIsNaN( values[i] )
+            ? 0u : colorIndex( numColors, interval, values[i] );
+    }
+}
+
 /*!
    Build and return a color map of 256 colors
 
@@ -554,6 +712,69 @@ uint QwtLinearColorMap::colorIndex( int numColors,
 #pragma GCC pop_options
 #endif
 
+/*!
+  \brief Map an array of values into RGB values
+
+  The stops of the previous value are checked before searching
+  the color stops, what is usually a hit for neighboured values.
+
+  \param interval Range for all values
+  \param values Values to map into RGB values
+  \param rgbs Array, where the RGB values are stored
+  \param count Number of values
+
+  \note NaN values are mapped to a transparent 0u
+*/
+void QwtLinearColorMap::rgbRow( const QwtInterval &interval,
+    const double *values, QRgb *rgbs, int count ) const
+{
+    const double width = interval.width();
+    if ( width <= 0.0 )
+    {
+        for ( int i = 0; i < count; i++ )
+            rgbs[i] = 0u;
+
+        return;
+    }
+
+    d_data->colorStops.rgbRow( d_data->mode,
+        interval.minValue(), width, values, rgbs, count );
+}
+
+/*!
+  \brief Map an array of values into color indexes
+
+  Returns the same indexes as colorIndex(), but calculates
+  2 indexes at once, when SSE2 is available.
+
+  \param numColors Size of the color table
+  \param interval Range for all values
+  \param values Values to map into color indexes
+  \param indexes Array, where the color indexes are stored
+  \param count Number of values
+
+  \note NaN values are mapped to 0
+*/
+void QwtLinearColorMap::colorIndexRow( int numColors,
+    const QwtInterval &interval, const double *values,
+    uint *indexes, int count ) const
+{
+    const double width = interval.width();
+    if ( width <= 0.0 )
+    {
+        for ( int i = 0; i < count; i++ )
+            indexes[i] = 0;
+
+        return;
+    }
+
+    const double offset = ( d_data->mode == FixedColors ) ? 0.0 : 0.5;
+
+    qwtColorIndexes( values, indexes, count,
+        interval.minValue(), interval.maxValue(), width,
+        numColors - 1, offset );
+}
+
 class QwtAlphaColorMap::PrivateData
 {
 public:
@@ -683,6 +904,63 @@ QRgb QwtAlphaColorMap::rgb( const QwtInterval &interval, double value ) const
     return d_data->rgb | ( alpha << 24 );
 }
 
+/*!
+  \brief Map an array of values into alpha values
+
+  \param interval Range for all values
+  \param values Values to map into RGB values
+  \param rgbs Array, where the RGB values are stored
+  \param count Number of values
+
+  \note NaN values are mapped to a transparent 0u
+*/
+void QwtAlphaColorMap::rgbRow( const QwtInterval &interval,
+    const double *values, QRgb *rgbs, int count ) const
+{
+    const double width = interval.width();
+    if ( width <= 0.0 )
+    {
+        for ( int i = 0; i < count; i++ )
+            rgbs[i] = 0u;
+
+        return;
+    }
+
+    const double min = interval.minValue();
+    const double max = interval.maxValue();
+
+    const QRgb rgb = d_data->rgb;
+    const QRgb rgbMax = d_data->rgbMax;
+
+    const int alpha1 = d_data->alpha1;
+    const double alphaRange = d_data->alpha2 - d_data->alpha1;
+
+    for ( int i = 0; i < count; i++ )
+    {
+        const double value = values[i];
+
+        if ( qIsNaN( value ) )
+        {
+            rgbs[i] = 0u;
+        }
+        else if ( value <= min )
+        {
+            rgbs[i] = rgb;
+        }
+        else if ( value >= max )
+        {
+            rgbs[i] = rgbMax;
+        }
+        else
+        {
+            const double ratio = ( value - min ) / width;
+            const int alpha = alpha1 + qRound( ratio * alphaRange );
+
+            rgbs[i] = rgb | ( alpha << 24 );
+        }
+    }
+}
+
 class QwtHueColorMap::PrivateData
 {
 public:
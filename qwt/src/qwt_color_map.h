@@ -76,6 +76,12 @@ public:
     virtual uint colorIndex( int numColors,
         const QwtInterval &interval, double value ) const;
 
+    virtual void rgbRow( const QwtInterval &interval,
+        const double *values, QRgb *rgbs, int count ) const;
+
+    virtual void colorIndexRow( int numColors, const QwtInterval &interval,
+        const double *values, uint *indexes, int count ) const;
+
     QColor color( const QwtInterval &, double value ) const;
     virtual QVector<QRgb> colorTable( int numColors ) const;
     virtual QVector<QRgb> colorTable256() const;
@@ -131,6 +137,12 @@ public:
     virtual uint colorIndex( int numColors,
         const QwtInterval &, double value ) const QWT_OVERRIDE;
 
+    virtual void rgbRow( const QwtInterval &,
+        const double *values, QRgb *rgbs, int count ) const QWT_OVERRIDE;
+
+    virtual void colorIndexRow( int numColors, const QwtInterval &,
+        const double *values, uint *indexes, int count ) const QWT_OVERRIDE;
+
     class ColorStops;
 
 private:
@@ -158,6 +170,9 @@ public:
     virtual QRgb rgb( const QwtInterval &,
         double value ) const QWT_OVERRIDE;
 
+    virtual void rgbRow( const QwtInterval &,
+        const double *values, QRgb *rgbs, int count ) const QWT_OVERRIDE;
+
 private:
     class PrivateData;
     PrivateData *d_data;
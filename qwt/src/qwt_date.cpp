@@ -373,6 +373,14 @@ double QwtDate::toDouble( const QDateTime &dateTime )
 {
     const int msecsPerDay = 86400000;
 
+#if QT_VERSION >= 0x050000
+    if ( dateTime.timeSpec() == Qt::UTC )
+    {
+        // UTC datetimes are stored as milliseconds since the epoch
+        return static_cast<double>( dateTime.toMSecsSinceEpoch() );
+    }
+#endif
+
     const QDateTime dt = qwtToTimeSpec( dateTime, Qt::UTC );
 
     const double days = dt.date().toJulianDay() - QwtDate::JulianDayForEpoch;
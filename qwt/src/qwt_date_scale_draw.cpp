@@ -10,13 +10,16 @@
 #include "qwt_date_scale_draw.h"
 #include "qwt_text.h"
 
+#include <qmap.h>
+
 class QwtDateScaleDraw::PrivateData
 {
 public:
     explicit PrivateData( Qt::TimeSpec spec ):
         timeSpec( spec ),
         utcOffset( 0 ),
-        week0Type( QwtDate::FirstThursday )
+        week0Type( QwtDate::FirstThursday ),
+        intervalType( -1 )
     {
         dateFormats[ QwtDate::Millisecond ] = "hh:mm:ss:zzz\nddd dd MMM yyyy";
         dateFormats[ QwtDate::Second ] = "hh:mm:ss\nddd dd MMM yyyy";
@@ -32,6 +35,26 @@ public:
     int utcOffset;
     QwtDate::Week0Type week0Type;
     QString dateFormats[ QwtDate::Year + 1 ];
+
+    void invalidateLabels()
+    {
+        intervalType = -1;
+        labels.clear();
+    }
+
+    // intervalType() of the most recent scale division
+    QwtScaleDiv intervalTypeDiv;
+    int intervalType;
+
+    class LabelEntry
+    {
+    public:
+        QString format;
+        QString text;
+    };
+
+    enum { MaxLabels = 1000 };
+    QMap<double, LabelEntry> labels;
 };
 
 /*!
@@ -64,7 +87,11 @@ QwtDateScaleDraw::~QwtDateScaleDraw()
  */
 void QwtDateScaleDraw::setTimeSpec( Qt::TimeSpec timeSpec )
 {
-    d_data->timeSpec = timeSpec;
+    if ( timeSpec != d_data->timeSpec )
+    {
+        d_data->timeSpec = timeSpec;
+        d_data->invalidateLabels();
+    }
 }
 
 /*!
@@ -88,7 +115,11 @@ Qt::TimeSpec QwtDateScaleDraw::timeSpec() const
  */
 void QwtDateScaleDraw::setUtcOffset( int seconds )
 {
-    d_data->utcOffset = seconds;
+    if ( seconds != d_data->utcOffset )
+    {
+        d_data->utcOffset = seconds;
+        d_data->invalidateLabels();
+    }
 }
 
 /*!
@@ -114,7 +145,11 @@ int QwtDateScaleDraw::utcOffset() const
  */
 void QwtDateScaleDraw::setWeek0Type( QwtDate::Week0Type week0Type )
 {
-    d_data->week0Type = week0Type;
+    if ( week0Type != d_data->week0Type )
+    {
+        d_data->week0Type = week0Type;
+        d_data->invalidateLabels();
+    }
 }
 
 /*!
@@ -197,6 +232,11 @@ QString QwtDateScaleDraw::dateFormatOfDate( const QDateTime &dateTime,
   The value is converted to a datetime value using toDateTime()
   and converted to a plain text using QwtDate::toString().
 
+  As formatting a datetime is expensive the strings are cached
+  and reused as long as dateFormatOfDate() returns the same format
+  for a value. The interval type is only recalculated, when the
+  scale division has changed.
+
   \param value Value
   \return Label string.
 
@@ -204,11 +244,31 @@ QString QwtDateScaleDraw::dateFormatOfDate( const QDateTime &dateTime,
 */
 QwtText QwtDateScaleDraw::label( double value ) const
 {
+    const QwtScaleDiv &div = scaleDiv();
+    if ( d_data->intervalType < 0 || div != d_data->intervalTypeDiv )
+    {
+        d_data->intervalType = intervalType( div );
+        d_data->intervalTypeDiv = div;
+    }
+
     const QDateTime dt = toDateTime( value );
-    const QString fmt = dateFormatOfDate(
-        dt, intervalType( scaleDiv() ) );
+    const QString fmt = dateFormatOfDate( dt,
+        static_cast<QwtDate::IntervalType>( d_data->intervalType ) );
+
+    QMap<double, PrivateData::LabelEntry>::const_iterator it =
+        d_data->labels.constFind( value );
+
+    if ( it != d_data->labels.constEnd() && it.value().format == fmt )
+        return it.value().text;
+
+    if ( d_data->labels.size() >= PrivateData::MaxLabels )
+        d_data->labels.clear();
+
+    PrivateData::LabelEntry &entry = d_data->labels[ value ];
+    entry.format = fmt;
+    entry.text = QwtDate::toString( dt, fmt, d_data->week0Type );
 
-    return QwtDate::toString( dt, fmt, d_data->week0Type );
+    return entry.text;
 }
 
 /*!
@@ -422,7 +422,7 @@ static QList<double> qwtDstTicks( const QDateTime &dateTime,
     int secondsMajor, int secondsMinor )
 {
     if ( secondsMinor <= 0 )
-        QList<double>();
+        return QList<double>();
 
     QDateTime minDate = dateTime.addSecs( -secondsMajor );
     minDate = QwtDate::floor( minDate, QwtDate::Hour );
@@ -450,6 +450,53 @@ static QList<double> qwtDstTicks( const QDateTime &dateTime,
     return ticks;
 }
 
+static QwtScaleDiv qwtDivideLinear( double minValue, double maxValue,
+    int secondsMajor, double secondsMinor )
+{
+    QList<double> majorTicks;
+    QList<double> mediumTicks;
+    QList<double> minorTicks;
+
+    const double majorStep = secondsMajor * 1000.0;
+    if ( majorStep > 0.0 )
+    {
+        const int numMinorSteps = ( secondsMinor > 0.0 )
+            ? qwtFloor( secondsMajor / secondsMinor ) : 0;
+
+        for ( int k = 0; ; k++ )
+        {
+            const double majorValue = minValue + k * majorStep;
+            if ( majorValue > maxValue )
+                break;
+
+            majorTicks += majorValue;
+
+            for ( int i = 1; i < numMinorSteps; i++ )
+            {
+                const double minorValue = majorValue +
+                    qRound64( i * secondsMinor * 1000 );
+
+                const bool isMedium = ( numMinorSteps % 2 == 0 )
+                    && ( i != 1 ) && ( i == numMinorSteps / 2 );
+
+                if ( isMedium )
+                    mediumTicks += minorValue;
+                else
+                    minorTicks += minorValue;
+            }
+        }
+    }
+
+    QwtScaleDiv scaleDiv;
+    scaleDiv.setInterval( minValue, maxValue );
+
+    scaleDiv.setTicks( QwtScaleDiv::MajorTick, majorTicks );
+    scaleDiv.setTicks( QwtScaleDiv::MediumTick, mediumTicks );
+    scaleDiv.setTicks( QwtScaleDiv::MinorTick, minorTicks );
+
+    return scaleDiv;
+}
+
 static QwtScaleDiv qwtDivideToSeconds(
     const QDateTime &minDate, const QDateTime &maxDate,
     double stepSize, int maxMinSteps,
@@ -478,6 +525,15 @@ static QwtScaleDiv qwtDivideToSeconds(
     const int secondsMajor = static_cast<int>( stepSize * s );
     const double secondsMinor = minStepSize * s;
 
+    if ( !daylightSaving )
+    {
+        // without daylight saving the ticks are at equidistant
+        // positions and can be calculated without QDateTime arithmetics
+
+        return qwtDivideLinear( QwtDate::toDouble( minDate ),
+            QwtDate::toDouble( maxDate ), secondsMajor, secondsMinor );
+    }
+
     // UTC excludes daylight savings. So from the difference
     // of a date and its UTC counterpart we can find out
     // the daylight saving hours
@@ -489,30 +545,37 @@ static QwtScaleDiv qwtDivideToSeconds(
     QList<double> mediumTicks;
     QList<double> minorTicks;
 
-    for ( QDateTime dt = minDate; dt <= maxDate;
-        dt = dt.addSecs( secondsMajor ) )
-    {
-        if ( !dt.isValid() )
-            break;
+    /*
+        Comparing the offsets at both ends of a major step detects
+        a DST transition only, when the step can't contain both
+        transitions of a year - unlike f.e. a step of 26 weeks.
+     */
+    const bool checkEnds = ( secondsMajor <= 24 * 3600 );
 
-        double majorValue = QwtDate::toDouble( dt );
+    QDateTime dt = minDate;
+    int dtOffset = QwtDate::utcOffset( dt );
 
-        if ( daylightSaving )
-        {
-            const double offset = utcOffset - QwtDate::utcOffset( dt );
-            majorValue += offset * 1000.0;
+    while ( dt <= maxDate && dt.isValid() )
+    {
+        const QDateTime nextDt = dt.addSecs( secondsMajor );
+        const int nextOffset = nextDt.isValid()
+            ? QwtDate::utcOffset( nextDt ) : dtOffset;
 
-            if ( offset > dstOff )
-            {
-                // we add some minor ticks for the DST hour,
-                // otherwise the ticks will be unaligned: 0, 2, 3, 5 ...
-                minorTicks += qwtDstTicks(
-                    dt, secondsMajor, qRound( secondsMinor ) );
-            }
+        const double dtValue = QwtDate::toDouble( dt );
+
+        const double offset = utcOffset - dtOffset;
+        const double majorValue = dtValue + offset * 1000.0;
 
-            dstOff = offset;
+        if ( offset > dstOff )
+        {
+            // we add some minor ticks for the DST hour,
+            // otherwise the ticks will be unaligned: 0, 2, 3, 5 ...
+            minorTicks += qwtDstTicks(
+                dt, secondsMajor, qRound( secondsMinor ) );
         }
 
+        dstOff = offset;
+
         if ( majorTicks.isEmpty() || majorTicks.last() != majorValue )
             majorTicks += majorValue;
 
@@ -522,14 +585,21 @@ static QwtScaleDiv qwtDivideToSeconds(
 
             for ( int i = 1; i < numMinorSteps; i++ )
             {
-                const QDateTime mt = dt.addMSecs(
-                    qRound64( i * secondsMinor * 1000 ) );
+                const qint64 msecs = qRound64( i * secondsMinor * 1000 );
 
-                double minorValue = QwtDate::toDouble( mt );
-                if ( daylightSaving )
+                double minorValue;
+                if ( checkEnds && nextOffset == dtOffset )
+                {
+                    // no DST transition in this interval: the offset
+                    // of the major tick is valid for all minor ticks
+                    minorValue = majorValue + msecs;
+                }
+                else
                 {
-                    const double offset = utcOffset - QwtDate::utcOffset( mt );
-                    minorValue += offset * 1000.0;
+                    const QDateTime mt = dt.addMSecs( msecs );
+
+                    minorValue = QwtDate::toDouble( mt ) +
+                        ( utcOffset - QwtDate::utcOffset( mt ) ) * 1000.0;
                 }
 
                 if ( minorTicks.isEmpty() || minorTicks.last() != minorValue )
@@ -544,6 +614,9 @@ static QwtScaleDiv qwtDivideToSeconds(
                 }
             }
         }
+
+        dt = nextDt;
+        dtOffset = nextOffset;
     }
 
     QwtScaleDiv scaleDiv;
@@ -13,11 +13,15 @@
 #include "qwt_math.h"
 #include "qwt_painter.h"
 #include "qwt_graphic.h"
+#include "qwt_text.h"
 
 #include <qapplication.h>
 #include <qscrollbar.h>
 #include <qscrollarea.h>
+#include <qabstractscrollarea.h>
 #include <qpainter.h>
+#include <qdrawutil.h>
+#include <qevent.h>
 
 namespace
 {
@@ -25,6 +29,7 @@ namespace
     {
     public:
         inline bool isEmpty() const { return d_entries.isEmpty(); }
+        inline void clear() { d_entries.clear(); }
 
         void insert( const QVariant &, const QList<QWidget *> & );
         void remove( const QVariant & );
@@ -124,12 +129,33 @@ QList<QWidget *> QwtLegendMap::legendWidgets( const QVariant &itemInfo ) const
     return QList<QWidget *>();
 }
 
+static void qwtPostLayoutRequest( QWidget *legend )
+{
+    QWidget *parent = legend->parentWidget();
+    if ( parent && parent->layout() == NULL )
+    {
+        /*
+           We want the parent widget ( usually QwtPlot ) to recalculate
+           its layout, when the contents of the legend have changed. But
+           because of the scroll view we have to forward the LayoutRequest
+           event manually.
+
+           We don't use updateGeometry() because it doesn't post LayoutRequest
+           events when the legend is hidden. But we want the
+           parent widget notified, so it can show/hide the legend
+           depending on its items.
+         */
+        QApplication::postEvent( parent, new QEvent( QEvent::LayoutRequest ) );
+    }
+}
+
 class QwtLegend::PrivateData
 {
 public:
     PrivateData():
         itemMode( QwtLegendData::ReadOnly ),
-        view( NULL )
+        view( NULL ),
+        virtualView( NULL )
     {
     }
 
@@ -138,6 +164,10 @@ public:
 
     class LegendView;
     LegendView *view;
+
+    // painting the entries without widgets, see QwtLegend::setVirtualized()
+    class VirtualView;
+    VirtualView *virtualView;
 };
 
 class QwtLegend::PrivateData::LegendView QWT_FINAL: public QScrollArea
@@ -249,6 +279,493 @@ public:
     QWidget *contentsWidget;
 };
 
+class QwtLegend::PrivateData::VirtualView QWT_FINAL: public QAbstractScrollArea
+{
+public:
+    class Row
+    {
+    public:
+        Row():
+            index( 0 ),
+            isChecked( false )
+        {
+        }
+
+        QVariant itemInfo;
+        int index;
+
+        QwtLegendData data;
+        bool isChecked;
+
+        // calculated/rendered on demand
+        QSize size;
+        QPixmap icon;
+    };
+
+    VirtualView( QwtLegend *legend, const QwtDynGridLayout *gridLayout ):
+        QAbstractScrollArea( legend ),
+        legend( legend ),
+        gridLayout( gridLayout ),
+        hint( 0 ),
+        pressedRow( -1 ),
+        isDirty( true )
+    {
+        setFrameStyle( NoFrame );
+        setFocusPolicy( Qt::NoFocus );
+
+        viewport()->setObjectName( "QwtLegendVirtualViewport" );
+        viewport()->setAutoFillBackground( false );
+    }
+
+    virtual bool event( QEvent *event ) QWT_OVERRIDE
+    {
+        if ( event->type() == QEvent::FontChange )
+            invalidate();
+
+        return QAbstractScrollArea::event( event );
+    }
+
+    virtual bool viewportEvent( QEvent *event ) QWT_OVERRIDE
+    {
+        bool ok = QAbstractScrollArea::viewportEvent( event );
+
+        if ( event->type() == QEvent::Resize )
+            layoutContents();
+
+        return ok;
+    }
+
+    void invalidate()
+    {
+        for ( int i = 0; i < rows.size(); i++ )
+            rows[i].size = QSize();
+
+        isDirty = true;
+    }
+
+    int findRow( const QVariant &itemInfo ) const
+    {
+        // the plot usually updates its items in the same order,
+        // so we start searching behind the previous match
+
+        const int numRows = rows.size();
+        for ( int i = 0; i < numRows; i++ )
+        {
+            const int row = ( hint + i ) % numRows;
+            if ( rows[row].index == 0 && rows[row].itemInfo == itemInfo )
+            {
+                hint = row;
+                return row;
+            }
+        }
+
+        return -1;
+    }
+
+    int rowCount( int firstRow ) const
+    {
+        int count = 1;
+        while ( firstRow + count < rows.size() && rows[firstRow + count].index > 0 )
+            count++;
+
+        return count;
+    }
+
+    bool updateRows( const QVariant &itemInfo,
+        const QList<QwtLegendData> &legendData )
+    {
+        int first = findRow( itemInfo );
+        int count = ( first >= 0 ) ? rowCount( first ) : 0;
+
+        if ( first < 0 )
+            first = rows.size();
+
+        bool changed = ( count != legendData.size() );
+
+        while ( count > legendData.size() )
+        {
+            rows.removeAt( first + --count );
+            pressedRow = -1;
+        }
+
+        for ( int i = 0; i < legendData.size(); i++ )
+        {
+            if ( i >= count )
+            {
+                Row row;
+                row.itemInfo = itemInfo;
+                row.index = i;
+
+                rows.insert( first + i, row );
+                pressedRow = -1;
+            }
+
+            Row &row = rows[first + i];
+
+            // measuring the title is expensive, so it is done only
+            // for rows, that might have a different size
+
+            const bool isResized = !hasSameSize( row, legendData[i] );
+
+            row.data = legendData[i];
+            row.icon = QPixmap();
+
+            if ( isResized )
+            {
+                const QSize size = rowSize( row );
+                if ( size != row.size )
+                {
+                    row.size = size;
+                    changed = true;
+                }
+            }
+        }
+
+        if ( changed )
+        {
+            isDirty = true;
+            layoutContents();
+        }
+
+        viewport()->update();
+
+        return changed;
+    }
+
+    void clear()
+    {
+        rows.clear();
+        hint = 0;
+        pressedRow = -1;
+        isDirty = true;
+
+        layoutContents();
+        viewport()->update();
+    }
+
+    QwtLegendData::Mode itemMode( const Row &row ) const
+    {
+        if ( row.data.hasRole( QwtLegendData::ModeRole ) )
+            return row.data.mode();
+
+        return legend->defaultItemMode();
+    }
+
+    int rowMargin( const Row &row ) const
+    {
+        int m = Margin;
+        if ( itemMode( row ) != QwtLegendData::ReadOnly )
+            m += ButtonFrame;
+
+        return m;
+    }
+
+    int textIndent( const Row &row ) const
+    {
+        // like the indent of a QwtLegendLabel
+        const int m = rowMargin( row );
+
+        int indent = 2 * m + Spacing;
+
+        const QSizeF iconSize = row.data.icon().defaultSize();
+        if ( iconSize.width() > 0 )
+            indent += qwtCeil( iconSize.width() ) + Spacing;
+
+        return indent;
+    }
+
+    bool hasSameSize( const Row &row, const QwtLegendData &data ) const
+    {
+        if ( !row.size.isValid() )
+            return false;
+
+        const bool hasMode = data.hasRole( QwtLegendData::ModeRole );
+        if ( hasMode != row.data.hasRole( QwtLegendData::ModeRole ) )
+            return false;
+
+        if ( hasMode && data.mode() != row.data.mode() )
+            return false;
+
+        return ( data.title() == row.data.title() )
+            && ( data.icon().defaultSize() == row.data.icon().defaultSize() );
+    }
+
+    QSize rowSize( const Row &row ) const
+    {
+        const int m = rowMargin( row );
+
+        const QSizeF textSize = row.data.title().textSize( font() );
+        const QSizeF iconSize = row.data.icon().defaultSize();
+
+        const int w = textIndent( row ) + qwtCeil( textSize.width() ) + m;
+        const int h = qMax( qwtCeil( textSize.height() ) + 2 * m,
+            qwtCeil( iconSize.height() ) + 4 );
+
+        return QSize( w, h );
+    }
+
+    QSize cellSize() const
+    {
+        if ( isDirty )
+        {
+            // all entries share the same size, so that the
+            // positions can be calculated without iterating
+
+            cell = QSize( 0, 0 );
+
+            for ( int i = 0; i < rows.size(); i++ )
+            {
+                Row &row = rows[i];
+                if ( !row.size.isValid() )
+                    row.size = rowSize( row );
+
+                cell = cell.expandedTo( row.size );
+            }
+
+            isDirty = false;
+        }
+
+        return cell;
+    }
+
+    int spacing() const
+    {
+        return gridLayout->spacing();
+    }
+
+    int margin() const
+    {
+        return gridLayout->margin();
+    }
+
+    int columnsForWidth( int width ) const
+    {
+        if ( rows.isEmpty() )
+            return 0;
+
+        int maxColumns = rows.size();
+        if ( gridLayout->maxColumns() > 0 )
+            maxColumns = qMin( static_cast<int>( gridLayout->maxColumns() ), maxColumns );
+
+        const int cw = cellSize().width() + spacing();
+        const int numColumns = ( width - 2 * margin() + spacing() ) / cw;
+
+        return qBound( 1, numColumns, maxColumns );
+    }
+
+    QSize layoutSize( int numColumns ) const
+    {
+        if ( numColumns <= 0 )
+            return QSize();
+
+        const QSize cell = cellSize();
+        const int numLines = ( rows.size() + numColumns - 1 ) / numColumns;
+
+        const int w = 2 * margin() + numColumns * cell.width()
+            + ( numColumns - 1 ) * spacing();
+
+        const int h = 2 * margin() + numLines * cell.height()
+            + ( numLines - 1 ) * spacing();
+
+        return QSize( w, h );
+    }
+
+    QSize contentsSizeHint() const
+    {
+        int numColumns = rows.size();
+        if ( gridLayout->maxColumns() > 0 )
+            numColumns = qMin( static_cast<int>( gridLayout->maxColumns() ), numColumns );
+
+        return layoutSize( numColumns );
+    }
+
+    int layoutHeight( int width ) const
+    {
+        if ( rows.isEmpty() )
+            return 0;
+
+        return layoutSize( columnsForWidth( width ) ).height();
+    }
+
+    int contentsWidth() const
+    {
+        return qMax( viewport()->width(),
+            cellSize().width() + 2 * margin() );
+    }
+
+    void layoutContents()
+    {
+        const QSize visibleSize = viewport()->size();
+
+        const int w = contentsWidth();
+        const int h = layoutHeight( w );
+
+        horizontalScrollBar()->setRange( 0, qMax( w - visibleSize.width(), 0 ) );
+        horizontalScrollBar()->setPageStep( visibleSize.width() );
+
+        verticalScrollBar()->setRange( 0, qMax( h - visibleSize.height(), 0 ) );
+        verticalScrollBar()->setPageStep( visibleSize.height() );
+        verticalScrollBar()->setSingleStep( cellSize().height() + spacing() );
+    }
+
+    QRect cellRect( int row, int numColumns ) const
+    {
+        const QSize cell = cellSize();
+
+        const int line = row / numColumns;
+        const int col = row % numColumns;
+
+        return QRect( margin() + col * ( cell.width() + spacing() ),
+            margin() + line * ( cell.height() + spacing() ),
+            cell.width(), cell.height() );
+    }
+
+    int rowAt( const QPoint &pos ) const
+    {
+        const QSize cell = cellSize();
+        if ( rows.isEmpty() || cell.isEmpty() )
+            return -1;
+
+        const int x = pos.x() + horizontalScrollBar()->value() - margin();
+        const int y = pos.y() + verticalScrollBar()->value() - margin();
+        if ( x < 0 || y < 0 )
+            return -1;
+
+        const int cw = cell.width() + spacing();
+        const int ch = cell.height() + spacing();
+
+        const int col = x / cw;
+        const int line = y / ch;
+
+        if ( x - col * cw >= cell.width() || y - line * ch >= cell.height() )
+            return -1;
+
+        const int numColumns = columnsForWidth( contentsWidth() );
+        if ( col >= numColumns )
+            return -1;
+
+        const int row = line * numColumns + col;
+        return ( row < rows.size() ) ? row : -1;
+    }
+
+    virtual void paintEvent( QPaintEvent *event ) QWT_OVERRIDE
+    {
+        const QSize cell = cellSize();
+        if ( rows.isEmpty() || cell.isEmpty() )
+            return;
+
+        QPainter painter( viewport() );
+        painter.setClipRegion( event->region() );
+
+        const int dx = horizontalScrollBar()->value();
+        const int dy = verticalScrollBar()->value();
+
+        const int numColumns = columnsForWidth( contentsWidth() );
+        const int ch = cell.height() + spacing();
+
+        // only the lines inside the exposed area are painted
+        const QRect r = event->rect().translated( dx, dy );
+
+        const int firstLine = qMax( r.top() - margin(), 0 ) / ch;
+        const int lastLine = qMax( r.bottom() - margin(), 0 ) / ch;
+
+        for ( int line = firstLine; line <= lastLine; line++ )
+        {
+            for ( int col = 0; col < numColumns; col++ )
+            {
+                const int row = line * numColumns + col;
+                if ( row >= rows.size() )
+                    return;
+
+                const QRect rect = cellRect( row, numColumns ).translated( -dx, -dy );
+                if ( rect.intersects( event->rect() ) )
+                    drawRow( &painter, rect, row, true );
+            }
+        }
+    }
+
+    void drawRow( QPainter *painter, const QRect &rect,
+        int index, bool showState ) const
+    {
+        Row &row = rows[index];
+
+        const QwtLegendData::Mode mode = itemMode( row );
+        const int m = rowMargin( row );
+
+        if ( showState )
+        {
+            const bool isDown = ( mode == QwtLegendData::Checkable && row.isChecked )
+                || ( mode == QwtLegendData::Clickable && index == pressedRow );
+
+            if ( isDown )
+            {
+                qDrawWinButton( painter, rect.x(), rect.y(),
+                    rect.width(), rect.height(), palette(), true );
+            }
+        }
+
+        painter->save();
+        painter->setClipRect( rect, Qt::IntersectClip );
+
+        const QwtGraphic graphic = row.data.icon();
+        if ( !graphic.isNull() )
+        {
+            const QSizeF sz = graphic.defaultSize();
+
+            QRectF iconRect( rect.x() + m, 0.0, sz.width(), sz.height() );
+            iconRect.moveCenter( QPointF( iconRect.center().x(),
+                rect.center().y() + 0.5 ) );
+
+            if ( showState )
+            {
+                // the icons are rendered, when being visible for the first time
+                if ( row.icon.isNull() )
+                    row.icon = graphic.toPixmap();
+
+                painter->drawPixmap( iconRect.toRect(), row.icon );
+            }
+            else
+            {
+                // rendering the vector graphic, f.e. when exporting the plot
+                graphic.render( painter, iconRect, Qt::KeepAspectRatio );
+            }
+        }
+
+        QwtText title = row.data.title();
+        title.setRenderFlags( Qt::AlignLeft | Qt::AlignVCenter | Qt::TextExpandTabs );
+
+        QRect textRect = rect;
+        textRect.setLeft( rect.left() + textIndent( row ) );
+        textRect.setRight( rect.right() - m );
+
+        painter->setFont( font() );
+        painter->setPen( palette().color( QPalette::Text ) );
+
+        title.draw( painter, textRect );
+
+        painter->restore();
+    }
+
+    QwtLegend *legend;
+    const QwtDynGridLayout *gridLayout;
+
+    mutable QList<Row> rows;
+    mutable int hint;
+
+    int pressedRow;
+
+private:
+    enum
+    {
+        Margin = 2,
+        ButtonFrame = 2,
+        Spacing = 2
+    };
+
+    mutable QSize cell;
+    mutable bool isDirty;
+};
+
 /*!
   Constructor
   \param parent Parent widget
@@ -298,6 +815,12 @@ void QwtLegend::setMaxColumns( uint numColums )
     if ( tl )
         tl->setMaxColumns( numColums );
 
+    if ( d_data->virtualView )
+    {
+        d_data->virtualView->layoutContents();
+        d_data->virtualView->viewport()->update();
+    }
+
     updateGeometry();
 }
 
@@ -361,6 +884,9 @@ QWidget *QwtLegend::contentsWidget()
 */
 QScrollBar *QwtLegend::horizontalScrollBar() const
 {
+    if ( d_data->virtualView )
+        return d_data->virtualView->horizontalScrollBar();
+
     return d_data->view->horizontalScrollBar();
 }
 
@@ -370,6 +896,9 @@ QScrollBar *QwtLegend::horizontalScrollBar() const
 */
 QScrollBar *QwtLegend::verticalScrollBar() const
 {
+    if ( d_data->virtualView )
+        return d_data->virtualView->verticalScrollBar();
+
     return d_data->view->verticalScrollBar();
 }
 
@@ -385,6 +914,162 @@ const QWidget *QwtLegend::contentsWidget() const
     return d_data->view->contentsWidget;
 }
 
+/*!
+  \brief En/disable the virtualized mode
+
+  In virtualized mode no widgets are created for the legend entries.
+  All entries share the same size and are painted into the viewport
+  of a single scroll area. Only the entries inside the visible area
+  are painted, and their icons are rendered, when becoming visible
+  for the first time. This is intended for plots with thousands of items,
+  where creating and laying out the widgets is too slow.
+
+  The entries can be clicked and checked like QwtLegendLabel
+  widgets, emitting the same clicked() and checked() signals.
+  As there are no widgets, legendWidget() and legendWidgets()
+  return nothing - setChecked() and isChecked() can be used instead.
+
+  The default setting is false.
+
+  \param on On/Off
+  \note Existing entries are removed. QwtPlot::updateLegend()
+        can be used to fill the legend again.
+
+  \sa isVirtualized(), setChecked(), isChecked()
+ */
+void QwtLegend::setVirtualized( bool on )
+{
+    if ( on == isVirtualized() )
+        return;
+
+    QLayout *contentsLayout = d_data->view->contentsWidget->layout();
+
+    if ( on )
+    {
+        // updates might be triggered by signals from a legend widget
+        // itself. So we better don't delete them here.
+
+        while ( QLayoutItem *item = contentsLayout->takeAt( 0 ) )
+        {
+            if ( QWidget *w = item->widget() )
+            {
+                w->hide();
+                w->deleteLater();
+            }
+
+            delete item;
+        }
+
+        d_data->itemMap.clear();
+
+        d_data->virtualView = new PrivateData::VirtualView( this,
+            qobject_cast<const QwtDynGridLayout *>( contentsLayout ) );
+        d_data->virtualView->setObjectName( "QwtLegendVirtualView" );
+        d_data->virtualView->viewport()->installEventFilter( this );
+
+        d_data->view->hide();
+        layout()->addWidget( d_data->virtualView );
+    }
+    else
+    {
+        d_data->virtualView->hide();
+        d_data->virtualView->deleteLater();
+        d_data->virtualView = NULL;
+
+        d_data->view->show();
+    }
+
+    updateGeometry();
+    qwtPostLayoutRequest( this );
+}
+
+/*!
+  \return True, when the legend is in virtualized mode
+  \sa setVirtualized()
+ */
+bool QwtLegend::isVirtualized() const
+{
+    return d_data->virtualView != NULL;
+}
+
+/*!
+  \brief Check/Uncheck an entry
+
+  Like QwtLegendLabel::setChecked() no checked() signal is emitted.
+  Entries, that are not in QwtLegendData::Checkable mode are ignored.
+
+  \param itemInfo Info for the item
+  \param on check/uncheck
+  \param index Index of the entry in the list of entries of the item
+
+  \sa isChecked(), QwtPlot::itemToInfo()
+ */
+void QwtLegend::setChecked( const QVariant &itemInfo, bool on, int index )
+{
+    if ( d_data->virtualView )
+    {
+        PrivateData::VirtualView *view = d_data->virtualView;
+
+        const int row = view->findRow( itemInfo );
+        if ( row >= 0 && index >= 0 && index < view->rowCount( row ) )
+        {
+            PrivateData::VirtualView::Row &r = view->rows[ row + index ];
+            if ( view->itemMode( r ) == QwtLegendData::Checkable
+                && r.isChecked != on )
+            {
+                r.isChecked = on;
+                view->viewport()->update();
+            }
+        }
+    }
+    else
+    {
+        const QList<QWidget *> widgetList = legendWidgets( itemInfo );
+        if ( index >= 0 && index < widgetList.size() )
+        {
+            QwtLegendLabel *label =
+                qobject_cast<QwtLegendLabel *>( widgetList[index] );
+            if ( label )
+                label->setChecked( on );
+        }
+    }
+}
+
+/*!
+  \param itemInfo Info for the item
+  \param index Index of the entry in the list of entries of the item
+
+  \return True, when the entry is checked
+  \sa setChecked()
+ */
+bool QwtLegend::isChecked( const QVariant &itemInfo, int index ) const
+{
+    if ( d_data->virtualView )
+    {
+        const PrivateData::VirtualView *view = d_data->virtualView;
+
+        const int row = view->findRow( itemInfo );
+        if ( row >= 0 && index >= 0 && index < view->rowCount( row ) )
+        {
+            const PrivateData::VirtualView::Row &r = view->rows[ row + index ];
+            return view->itemMode( r ) == QwtLegendData::Checkable && r.isChecked;
+        }
+
+        return false;
+    }
+
+    const QList<QWidget *> widgetList = legendWidgets( itemInfo );
+    if ( index >= 0 && index < widgetList.size() )
+    {
+        const QwtLegendLabel *label =
+            qobject_cast<const QwtLegendLabel *>( widgetList[index] );
+        if ( label )
+            return label->isChecked();
+    }
+
+    return false;
+}
+
 /*!
   \brief Update the entries for an item
 
@@ -394,6 +1079,17 @@ const QWidget *QwtLegend::contentsWidget() const
 void QwtLegend::updateLegend( const QVariant &itemInfo,
     const QList<QwtLegendData> &legendData )
 {
+    if ( d_data->virtualView )
+    {
+        if ( d_data->virtualView->updateRows( itemInfo, legendData ) )
+        {
+            updateGeometry();
+            qwtPostLayoutRequest( this );
+        }
+
+        return;
+    }
+
     QList<QWidget *> widgetList = legendWidgets( itemInfo );
 
     if ( widgetList.size() != legendData.size() )
@@ -525,7 +1221,12 @@ void QwtLegend::updateTabOrder()
 //! Return a size hint.
 QSize QwtLegend::sizeHint() const
 {
-    QSize hint = d_data->view->contentsWidget->sizeHint();
+    QSize hint;
+    if ( d_data->virtualView )
+        hint = d_data->virtualView->contentsSizeHint();
+    else
+        hint = d_data->view->contentsWidget->sizeHint();
+
     hint += QSize( 2 * frameWidth(), 2 * frameWidth() );
 
     return hint;
@@ -539,7 +1240,12 @@ int QwtLegend::heightForWidth( int width ) const
 {
     width -= 2 * frameWidth();
 
-    int h = d_data->view->contentsWidget->heightForWidth( width );
+    int h;
+    if ( d_data->virtualView )
+        h = d_data->virtualView->layoutHeight( width );
+    else
+        h = d_data->view->contentsWidget->heightForWidth( width );
+
     if ( h >= 0 )
         h += 2 * frameWidth();
 
@@ -549,7 +1255,8 @@ int QwtLegend::heightForWidth( int width ) const
 
 /*!
   Handle QEvent::ChildRemoved andQEvent::LayoutRequest events
-  for the contentsWidget().
+  for the contentsWidget() and mouse events for the entries
+  in virtualized mode.
 
   \param object Object to be filtered
   \param event Event
@@ -558,6 +1265,17 @@ int QwtLegend::heightForWidth( int width ) const
 */
 bool QwtLegend::eventFilter( QObject *object, QEvent *event )
 {
+    if ( d_data->virtualView && object == d_data->virtualView->viewport() )
+    {
+        if ( event->type() == QEvent::MouseButtonPress ||
+            event->type() == QEvent::MouseButtonRelease )
+        {
+            const QMouseEvent *mouseEvent = static_cast<const QMouseEvent *>( event );
+            if ( mouseEvent->button() == Qt::LeftButton )
+                virtualMouseEvent( mouseEvent );
+        }
+    }
+
     if ( object == d_data->view->contentsWidget )
     {
         switch ( event->type() )
@@ -582,23 +1300,8 @@ bool QwtLegend::eventFilter( QObject *object, QEvent *event )
             case QEvent::LayoutRequest:
             {
                 d_data->view->layoutContents();
+                qwtPostLayoutRequest( this );
 
-                if ( parentWidget() && parentWidget()->layout() == NULL )
-                {
-                    /*
-                       We want the parent widget ( usually QwtPlot ) to recalculate
-                       its layout, when the contentsWidget has changed. But
-                       because of the scroll view we have to forward the LayoutRequest
-                       event manually.
-
-                       We don't use updateGeometry() because it doesn't post LayoutRequest
-                       events when the legend is hidden. But we want the
-                       parent widget notified, so it can show/hide the legend
-                       depending on its items.
-                     */
-                    QApplication::postEvent( parentWidget(),
-                        new QEvent( QEvent::LayoutRequest ) );
-                }
                 break;
             }
             default:
@@ -609,6 +1312,60 @@ bool QwtLegend::eventFilter( QObject *object, QEvent *event )
     return QwtAbstractLegend::eventFilter( object, event );
 }
 
+void QwtLegend::virtualMouseEvent( const QMouseEvent *mouseEvent )
+{
+    typedef PrivateData::VirtualView::Row Row;
+
+    PrivateData::VirtualView *view = d_data->virtualView;
+
+    if ( mouseEvent->type() == QEvent::MouseButtonPress )
+    {
+        const int row = view->rowAt( mouseEvent->pos() );
+        if ( row < 0 )
+            return;
+
+        Row &r = view->rows[row];
+
+        switch( view->itemMode( r ) )
+        {
+            case QwtLegendData::Clickable:
+            {
+                view->pressedRow = row;
+                view->viewport()->update();
+                break;
+            }
+            case QwtLegendData::Checkable:
+            {
+                r.isChecked = !r.isChecked;
+                view->viewport()->update();
+
+                // the slots might modify the legend
+                const QVariant itemInfo = r.itemInfo;
+                const bool on = r.isChecked;
+                const int index = r.index;
+
+                Q_EMIT checked( itemInfo, on, index );
+                break;
+            }
+            default:;
+        }
+    }
+    else
+    {
+        const int row = view->pressedRow;
+        if ( row < 0 )
+            return;
+
+        view->pressedRow = -1;
+        view->viewport()->update();
+
+        const QVariant itemInfo = view->rows[row].itemInfo;
+        const int index = view->rows[row].index;
+
+        Q_EMIT clicked( itemInfo, index );
+    }
+}
+
 /*!
   Called internally when the legend has been clicked on.
   Emits a clicked() signal.
@@ -665,7 +1422,7 @@ void QwtLegend::itemChecked( bool on )
 void QwtLegend::renderLegend( QPainter *painter,
     const QRectF &rect, bool fillBackground ) const
 {
-    if ( d_data->itemMap.isEmpty() )
+    if ( isEmpty() )
         return;
 
     if ( fillBackground )
@@ -691,6 +1448,22 @@ void QwtLegend::renderLegend( QPainter *painter,
     layoutRect.setRight( qwtFloor( rect.right() ) - right );
     layoutRect.setBottom( qwtFloor( rect.bottom() ) - bottom );
 
+    if ( d_data->virtualView )
+    {
+        const PrivateData::VirtualView *view = d_data->virtualView;
+
+        const int numColumns = view->columnsForWidth( layoutRect.width() );
+        for ( int i = 0; i < view->rows.size(); i++ )
+        {
+            const QRect r = view->cellRect( i, numColumns ).translated(
+                layoutRect.topLeft() );
+
+            view->drawRow( painter, r, i, false );
+        }
+
+        return;
+    }
+
     uint numCols = legendLayout->columnsForWidth( layoutRect.width() );
     const QList<QRect> itemRects =
         legendLayout->layoutItems( layoutRect, numCols );
@@ -806,6 +1579,9 @@ QVariant QwtLegend::itemInfo( const QWidget *widget ) const
 //! \return True, when no item is inserted
 bool QwtLegend::isEmpty() const
 {
+    if ( d_data->virtualView )
+        return d_data->virtualView->rows.isEmpty();
+
     return d_data->itemMap.isEmpty();
 }
 
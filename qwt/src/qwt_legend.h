@@ -17,6 +17,7 @@
 #include <qvariant.h>
 
 class QScrollBar;
+class QMouseEvent;
 
 /*!
   \brief The legend widget
@@ -25,6 +26,10 @@ class QScrollBar;
   items might be any type of widget, but in general they will be
   a QwtLegendLabel.
 
+  For plots with thousands of items the legend can be switched into
+  a virtualized mode, where the entries are painted without widgets.
+  \sa setVirtualized()
+
   \sa QwtLegendLabel, QwtPlotItem, QwtPlot
 */
 
@@ -42,6 +47,12 @@ public:
     void setDefaultItemMode( QwtLegendData::Mode );
     QwtLegendData::Mode defaultItemMode() const;
 
+    void setVirtualized( bool );
+    bool isVirtualized() const;
+
+    void setChecked( const QVariant &, bool on, int index = 0 );
+    bool isChecked( const QVariant &, int index = 0 ) const;
+
     QWidget *contentsWidget();
     const QWidget *contentsWidget() const;
 
@@ -111,6 +122,7 @@ protected:
 
 private:
     void updateTabOrder();
+    void virtualMouseEvent( const QMouseEvent * );
 
     class PrivateData;
     PrivateData *d_data;
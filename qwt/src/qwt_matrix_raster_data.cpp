@@ -297,6 +297,111 @@ double QwtMatrixRasterData::value( double x, double y ) const
     return value;
 }
 
+/*!
+   \brief Find the values for a row of positions
+
+   The row of the matrix and its weights ( BilinearInterpolation )
+   are calculated once for all positions, so that only the column
+   has to be found for each position.
+
+   \param y Y value in plot coordinates
+   \param x Array of X values in plot coordinates
+   \param values Array, where the values are stored
+   \param count Number of positions
+
+   \sa value(), ResampleMode
+*/
+void QwtMatrixRasterData::valueRow( double y, const double *x,
+    double *values, int count ) const
+{
+    const QwtInterval xInterval = interval( Qt::XAxis );
+    const QwtInterval yInterval = interval( Qt::YAxis );
+
+    if ( !yInterval.contains( y ) )
+    {
+        for ( int i = 0; i < count; i++ )
+            values[i] = qQNaN();
+
+        return;
+    }
+
+    const double xMin = xInterval.minValue();
+    const double dx = d_data->dx;
+    const int numColumns = d_data->numColumns;
+
+    switch( d_data->resampleMode )
+    {
+        case BilinearInterpolation:
+        {
+            int row1 = qRound( (y - yInterval.minValue() ) / d_data->dy ) - 1;
+            int row2 = row1 + 1;
+
+            if ( row1 < 0 )
+                row1 = row2;
+            else if ( row2 >= d_data->numRows )
+                row2 = row1;
+
+            const double y2 = yInterval.minValue() +
+                ( row2 + 0.5 ) * d_data->dy;
+            const double ry = ( y2 - y ) / d_data->dy;
+
+            const double *line1 = d_data->values.constData() + row1 * numColumns;
+            const double *line2 = d_data->values.constData() + row2 * numColumns;
+
+            for ( int i = 0; i < count; i++ )
+            {
+                if ( !xInterval.contains( x[i] ) )
+                {
+                    values[i] = qQNaN();
+                    continue;
+                }
+
+                int col1 = qRound( ( x[i] - xMin ) / dx ) - 1;
+                int col2 = col1 + 1;
+
+                if ( col1 < 0 )
+                    col1 = col2;
+                else if ( col2 >= numColumns )
+                    col2 = col1;
+
+                const double x2 = xMin + ( col2 + 0.5 ) * dx;
+                const double rx = ( x2 - x[i] ) / dx;
+
+                const double vr1 = rx * line1[col1] + ( 1.0 - rx ) * line1[col2];
+                const double vr2 = rx * line2[col1] + ( 1.0 - rx ) * line2[col2];
+
+                values[i] = ry * vr1 + ( 1.0 - ry ) * vr2;
+            }
+
+            break;
+        }
+        case NearestNeighbour:
+        default:
+        {
+            int row = int( (y - yInterval.minValue() ) / d_data->dy );
+            if ( row >= d_data->numRows )
+                row = d_data->numRows - 1;
+
+            const double *line = d_data->values.constData() + row * numColumns;
+
+            for ( int i = 0; i < count; i++ )
+            {
+                if ( !xInterval.contains( x[i] ) )
+                {
+                    values[i] = qQNaN();
+                    continue;
+                }
+
+                int col = int( ( x[i] - xMin ) / dx );
+                if ( col >= numColumns )
+                    col = numColumns - 1;
+
+                values[i] = line[col];
+            }
+        }
+    }
+}
+
 void QwtMatrixRasterData::update()
 {
     d_data->numRows = 0;
@@ -66,6 +66,9 @@ public:
 
     virtual double value( double x, double y ) const QWT_OVERRIDE;
 
+    virtual void valueRow( double y, const double *x,
+        double *values, int count ) const QWT_OVERRIDE;
+
 private:
     void update();
 
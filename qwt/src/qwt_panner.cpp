@@ -46,6 +46,8 @@ public:
         hasCursor( false ),
 #endif
         isEnabled( false ),
+        tracking( false ),
+        isDragging( false ),
         orientations( Qt::Vertical | Qt::Horizontal )
     {
     }
@@ -76,6 +78,8 @@ public:
     bool hasCursor;
 #endif
     bool isEnabled;
+    bool tracking;
+    bool isDragging;
     Qt::Orientations orientations;
 };
 
@@ -202,6 +206,8 @@ void QwtPanner::setEnabled( bool on )
             {
                 w->removeEventFilter( this );
                 hide();
+
+                d_data->isDragging = false;
             }
         }
     }
@@ -233,6 +239,34 @@ bool QwtPanner::isOrientationEnabled( Qt::Orientation o ) const
     return d_data->orientations & o;
 }
 
+/*!
+   \brief En/disable tracking
+
+   When tracking is enabled the contents of the widget are not grabbed.
+   Instead panned() is emitted for each mouse move with the offset
+   since the previous position, so that the observed widget can follow
+   the mouse by itself. Aborting restores the initial position by
+   a final panned() signal.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa hasTracking(), panned()
+*/
+void QwtPanner::setTracking( bool on )
+{
+    d_data->tracking = on;
+}
+
+/*!
+   \return true, when tracking is enabled
+   \sa setTracking()
+*/
+bool QwtPanner::hasTracking() const
+{
+    return d_data->tracking;
+}
+
 /*!
   \return true when enabled, false otherwise
   \sa setEnabled, eventFilter()
@@ -396,6 +430,13 @@ void QwtPanner::widgetMousePressEvent( QMouseEvent *mouseEvent )
 
     d_data->initialPos = d_data->pos = mouseEvent->pos();
 
+    if ( d_data->tracking )
+    {
+        // the widget follows the mouse without grabbing
+        d_data->isDragging = true;
+        return;
+    }
+
     setGeometry( parentWidget()->rect() );
 
     // We don't want to grab the picker !
@@ -420,7 +461,7 @@ void QwtPanner::widgetMousePressEvent( QMouseEvent *mouseEvent )
 */
 void QwtPanner::widgetMouseMoveEvent( QMouseEvent *mouseEvent )
 {
-    if ( !isVisible() )
+    if ( !( isVisible() || d_data->isDragging ) )
         return;
 
     QPoint pos = mouseEvent->pos();
@@ -429,10 +470,22 @@ void QwtPanner::widgetMouseMoveEvent( QMouseEvent *mouseEvent )
     if ( !isOrientationEnabled( Qt::Vertical ) )
         pos.setY( d_data->initialPos.y() );
 
-    if ( pos != d_data->pos && rect().contains( pos ) )
+    const QRect r = d_data->isDragging ? parentWidget()->rect() : rect();
+
+    if ( pos != d_data->pos && r.contains( pos ) )
     {
-        d_data->pos = pos;
-        update();
+        if ( d_data->isDragging )
+        {
+            const QPoint delta = pos - d_data->pos;
+            d_data->pos = pos;
+
+            Q_EMIT panned( delta.x(), delta.y() );
+        }
+        else
+        {
+            d_data->pos = pos;
+            update();
+        }
 
         Q_EMIT moved( d_data->pos.x() - d_data->initialPos.x(),
             d_data->pos.y() - d_data->initialPos.y() );
@@ -448,6 +501,16 @@ void QwtPanner::widgetMouseMoveEvent( QMouseEvent *mouseEvent )
 */
 void QwtPanner::widgetMouseReleaseEvent( QMouseEvent *mouseEvent )
 {
+    if ( d_data->isDragging )
+    {
+        d_data->isDragging = false;
+#ifndef QT_NO_CURSOR
+        showCursor( false );
+#endif
+        // all offsets have been emitted while moving
+        return;
+    }
+
     if ( isVisible() )
     {
         hide();
@@ -484,6 +547,17 @@ void QwtPanner::widgetKeyPressEvent( QKeyEvent *keyEvent )
     if ( ( keyEvent->key() == d_data->abortKey )
         && ( keyEvent->modifiers() == d_data->abortKeyModifiers ) )
     {
+        if ( d_data->isDragging )
+        {
+            d_data->isDragging = false;
+
+            const QPoint delta = d_data->initialPos - d_data->pos;
+            d_data->pos = d_data->initialPos;
+
+            if ( !delta.isNull() )
+                Q_EMIT panned( delta.x(), delta.y() );
+        }
+
         hide();
 
 #ifndef QT_NO_CURSOR
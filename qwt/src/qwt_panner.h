@@ -59,14 +59,22 @@ public:
 
     bool isOrientationEnabled( Qt::Orientation ) const;
 
+    void setTracking( bool );
+    bool hasTracking() const;
+
     virtual bool eventFilter( QObject *, QEvent * ) QWT_OVERRIDE;
 
 Q_SIGNALS:
     /*!
       Signal emitted, when panning is done
 
+      With tracking enabled the signal is emitted for each
+      mouse move with the offset since the previous position.
+
       \param dx Offset in horizontal direction
       \param dy Offset in vertical direction
+
+      \sa setTracking()
     */
     void panned( int dx, int dy );
 
@@ -17,12 +17,15 @@
 #include "qwt_legend.h"
 #include "qwt_legend_data.h"
 #include "qwt_plot_canvas.h"
+#include "qwt_plot_profiler.h"
 #include "qwt_math.h"
 
 #include <qpainter.h>
 #include <qpointer.h>
 #include <qapplication.h>
 #include <qcoreevent.h>
+#include <qelapsedtimer.h>
+#include <qthreadstorage.h>
 
 static inline void qwtEnableLegendItems( QwtPlot *plot, bool on )
 {
@@ -92,6 +95,11 @@ public:
     QPointer<QWidget> canvas;
     QPointer<QwtAbstractLegend> legend;
     QwtPlotLayout *layout;
+    QwtPlotProfiler *profiler;
+
+    // layer + 1 of the items painted in drawItems(), 0 for all items.
+    // Per thread, as frames might be rendered in a worker thread.
+    QThreadStorage<int> layerFilter;
 
     bool autoReplot;
 };
@@ -137,6 +145,7 @@ void QwtPlot::initPlot( const QwtText &title )
     d_data = new PrivateData;
 
     d_data->layout = new QwtPlotLayout;
+    d_data->profiler = NULL;
     d_data->autoReplot = false;
 
     // title
@@ -318,6 +327,31 @@ bool QwtPlot::autoReplot() const
     return d_data->autoReplot;
 }
 
+/*!
+  \brief Assign a profiler
+
+  The profiler receives the timing of updateAxes(), updateLayout(),
+  drawItems() and of each plot item. The canvas reports the time
+  for painting and copying its backing store.
+
+  \param profiler Profiler, or NULL to disable the instrumentation
+  \note The plot doesn't take ownership of the profiler
+  \sa profiler(), QwtPlotProfileCollector
+*/
+void QwtPlot::setProfiler( QwtPlotProfiler *profiler )
+{
+    d_data->profiler = profiler;
+}
+
+/*!
+  \return Profiler, or NULL when no profiler has been assigned
+  \sa setProfiler()
+*/
+QwtPlotProfiler *QwtPlot::profiler() const
+{
+    return d_data->profiler;
+}
+
 /*!
   Change the plot's title
   \param title New title
@@ -538,10 +572,36 @@ void QwtPlot::resizeEvent( QResizeEvent *e )
 */
 void QwtPlot::replot()
 {
+    QwtPlotCanvas *canvas = qobject_cast<QwtPlotCanvas *>( d_data->canvas.data() );
+    if ( canvas && canvas->isRenderingFrame() )
+    {
+        /*
+          The items are painted in a background thread and must not
+          be touched by updateAxes(). The canvas remembers, that
+          the frame is outdated, and calls replot() again, when
+          the frame has been finished.
+         */
+        canvas->replot();
+        return;
+    }
+
     bool doAutoReplot = autoReplot();
     setAutoReplot( false );
 
-    updateAxes();
+    if ( d_data->profiler )
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        updateAxes();
+
+        d_data->profiler->phaseFinished(
+            QwtPlotProfiler::UpdateAxes, timer.nsecsElapsed() );
+    }
+    else
+    {
+        updateAxes();
+    }
 
     /*
       Maybe the layout needs to be updated, because of changed
@@ -570,6 +630,10 @@ void QwtPlot::replot()
 */
 void QwtPlot::updateLayout()
 {
+    QElapsedTimer timer;
+    if ( d_data->profiler )
+        timer.start();
+
     d_data->layout->activate( this, contentsRect() );
 
     QRect titleRect = d_data->layout->titleRect().toRect();
@@ -640,6 +704,12 @@ void QwtPlot::updateLayout()
     }
 
     d_data->canvas->setGeometry( canvasRect );
+
+    if ( d_data->profiler )
+    {
+        d_data->profiler->phaseFinished(
+            QwtPlotProfiler::UpdateLayout, timer.nsecsElapsed() );
+    }
 }
 
 /*!
@@ -734,6 +804,40 @@ void QwtPlot::drawCanvas( QPainter *painter )
     drawItems( painter, d_data->canvas->contentsRect(), maps );
 }
 
+/*!
+  \brief Restrict drawItems() to the items of a layer
+
+  Used by the canvas for rendering the layers of a backing store
+  separately. Items with a QwtPlotItem::renderLayer() < 0 belong
+  to layer 0.
+
+  The filter is stored for the calling thread only.
+
+  \param on When on, only the items of layer are painted
+  \param layer Layer
+  \sa hasLayerFilter(), QwtPlotItem::setRenderLayer()
+*/
+void QwtPlot::setLayerFilter( bool on, int layer )
+{
+    d_data->layerFilter.setLocalData( on ? qMax( layer, 0 ) + 1 : 0 );
+}
+
+/*!
+  \param layer Returns the layer of the filter, when not NULL
+  \return True, when drawItems() is restricted to the items of a layer
+  \sa setLayerFilter()
+*/
+bool QwtPlot::hasLayerFilter( int *layer ) const
+{
+    const int filter = d_data->layerFilter.hasLocalData()
+        ? d_data->layerFilter.localData() : 0;
+
+    if ( layer )
+        *layer = qMax( filter - 1, 0 );
+
+    return filter > 0;
+}
+
 /*!
   Redraw the canvas items.
 
@@ -745,11 +849,33 @@ void QwtPlot::drawCanvas( QPainter *painter )
         Due to a bug in Qt this rectangle might be wrong for certain
         frame styles ( f.e QFrame::Box ) and it might be necessary to
         fix the margins manually using QWidget::setContentsMargins()
+
+  \sa setLayerFilter()
 */
 
 void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
         const QwtScaleMap maps[axisCnt] ) const
 {
+    QwtPlotProfiler *profiler = d_data->profiler;
+
+    int layer = 0;
+    const bool doFilter = hasLayerFilter( &layer );
+
+    QElapsedTimer timer;
+    if ( profiler )
+        timer.start();
+
+    // f.e. the exposed strips, when scrolling the backing store
+    bool isPartial = false;
+    if ( profiler && painter->hasClipping() )
+    {
+        // tolerating rounding errors of clip paths
+        const QRectF clipRect =
+            painter->clipBoundingRect().adjusted( -1.0, -1.0, 1.0, 1.0 );
+
+        isPartial = !clipRect.contains( canvasRect );
+    }
+
     const QwtPlotItemList& itmList = itemList();
     for ( QwtPlotItemIterator it = itmList.begin();
         it != itmList.end(); ++it )
@@ -757,6 +883,11 @@ void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
         QwtPlotItem *item = *it;
         if ( item && item->isVisible() )
         {
+            if ( doFilter && qMax( item->renderLayer(), 0 ) != layer )
+                continue;
+
+            const qint64 itemStart = profiler ? timer.nsecsElapsed() : 0;
+
             painter->save();
 
             painter->setRenderHint( QPainter::Antialiasing,
@@ -770,8 +901,20 @@ void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
                 canvasRect );
 
             painter->restore();
+
+            if ( profiler && !isPartial )
+            {
+                profiler->itemDrawn( item,
+                    timer.nsecsElapsed() - itemStart );
+            }
         }
     }
+
+    if ( profiler )
+    {
+        profiler->phaseFinished( isPartial ? QwtPlotProfiler::DrawItemsPartial
+            : QwtPlotProfiler::DrawItems, timer.nsecsElapsed() );
+    }
 }
 
 /*!
@@ -1069,6 +1212,15 @@ void QwtPlot::updateLegendItems( const QVariant &itemInfo,
  */
 void QwtPlot::attachItem( QwtPlotItem *plotItem, bool on )
 {
+    QwtPlotCanvas *canvas = qobject_cast<QwtPlotCanvas *>( d_data->canvas.data() );
+    if ( canvas )
+    {
+        // a frame, that is rendered in the background, might access the item
+        canvas->waitForFrame();
+
+        canvas->markLayerDirty( plotItem->renderLayer() );
+    }
+
     if ( plotItem->testItemInterest( QwtPlotItem::LegendInterest ) )
     {
         // plotItem is some sort of legend
@@ -25,6 +25,7 @@ class QwtScaleDraw;
 class QwtTextLabel;
 class QwtInterval;
 class QwtText;
+class QwtPlotProfiler;
 template <typename T> class QList;
 
 /*!
@@ -139,6 +140,9 @@ public:
     void setAutoReplot( bool = true );
     bool autoReplot() const;
 
+    void setProfiler( QwtPlotProfiler * );
+    QwtPlotProfiler *profiler() const;
+
     // Layout
 
     void setPlotLayout( QwtPlotLayout * );
@@ -241,6 +245,9 @@ public:
     virtual void updateLayout();
     virtual void drawCanvas( QPainter * );
 
+    void setLayerFilter( bool on, int layer = 0 );
+    bool hasLayerFilter( int *layer = NULL ) const;
+
     void updateAxes();
     void updateCanvasMargins();
 
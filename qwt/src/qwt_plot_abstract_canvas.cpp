@@ -870,6 +870,23 @@ void QwtPlotAbstractCanvas::drawCanvas( QPainter *painter )
     painter->restore();
 }
 
+/*!
+  \brief Restrict drawCanvas() to the items of a layer
+
+  Used for rendering the layers of a backing store separately.
+  The filter is applied in QwtPlot::drawItems().
+
+  \param on When on, only the items of layer are painted
+  \param layer Layer
+  \sa QwtPlot::setLayerFilter(), QwtPlotItem::setRenderLayer()
+*/
+void QwtPlotAbstractCanvas::setLayerFilter( bool on, int layer )
+{
+    QwtPlot *plot = qobject_cast< QwtPlot *>( canvasWidget()->parent() );
+    if ( plot )
+        plot->setLayerFilter( on, layer );
+}
+
 //! Update the cached information about the current style sheet
 void QwtPlotAbstractCanvas::updateStyleSheetInfo()
 {
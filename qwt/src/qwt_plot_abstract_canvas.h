@@ -68,6 +68,8 @@ protected:
     void drawStyled( QPainter *, bool );
     void drawUnstyled( QPainter * );
 
+    void setLayerFilter( bool on, int layer = 0 );
+
     QPainterPath borderPath2( const QRect &rect ) const;
     void updateStyleSheetInfo();
 
@@ -62,6 +62,8 @@ QwtPlotBarChart::~QwtPlotBarChart()
 
 void QwtPlotBarChart::init()
 {
+    setItemAttribute( QwtPlotItem::Scrollable, true );
+
     d_data = new PrivateData;
     setData( new QwtPointSeriesData() );
 }
@@ -135,6 +137,8 @@ void QwtPlotBarChart::setSymbol( QwtColumnSymbol *symbol )
 {
     if ( symbol != d_data->symbol )
     {
+        waitForFrame();
+
         delete d_data->symbol;
         d_data->symbol = symbol;
 
@@ -10,6 +10,8 @@
 #include "qwt_plot_canvas.h"
 #include "qwt_painter.h"
 #include "qwt_plot.h"
+#include "qwt_plot_profiler.h"
+#include "qwt_scale_map.h"
 
 #ifndef QWT_NO_OPENGL
 
@@ -46,6 +48,100 @@ typedef QGLWidget QwtPlotCanvasSurfaceGL;
 
 #include <qpainter.h>
 #include <qevent.h>
+#include <qmap.h>
+#include <qlist.h>
+#include <qvector.h>
+#include <qelapsedtimer.h>
+#include <qfuture.h>
+#include <qfuturewatcher.h>
+#include <qtconcurrentrun.h>
+
+#if !defined(QT_NO_QFUTURE)
+#define QWT_USE_THREADS 1
+#endif
+
+#if QWT_USE_THREADS
+
+namespace
+{
+    // state of the plot, that is copied before a frame is rendered
+    class FrameCommand
+    {
+    public:
+        QwtPlot *plot;
+
+        QSize size;
+        qreal pixelRatio;
+        QRect contentsRect;
+
+        QwtScaleMap maps[QwtPlot::axisCnt];
+
+        // the layers > 0 are not part of the backing store
+        bool doLayers;
+    };
+}
+
+static QImage qwtRenderFrame( const FrameCommand &command )
+{
+    QImage image( command.size * command.pixelRatio,
+        QImage::Format_ARGB32_Premultiplied );
+#if QT_VERSION >= 0x050000
+    image.setDevicePixelRatio( command.pixelRatio );
+#endif
+    image.fill( 0 );
+
+    QPainter painter( &image );
+    painter.setClipRect( command.contentsRect, Qt::IntersectClip );
+
+    // the layer filter is stored for the worker thread only
+    command.plot->setLayerFilter( command.doLayers, 0 );
+    command.plot->drawItems( &painter, command.contentsRect, command.maps );
+    command.plot->setLayerFilter( false );
+
+    return image;
+}
+
+#endif
+
+static QVector<QwtScaleMap> qwtCanvasMaps( const QwtPlot *plot )
+{
+    QVector<QwtScaleMap> maps;
+
+    if ( plot )
+    {
+        maps.reserve( QwtPlot::axisCnt );
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+            maps += plot->canvasMap( axisId );
+    }
+
+    return maps;
+}
+
+static bool qwtIsSameMaps( const QVector<QwtScaleMap> &maps1,
+    const QVector<QwtScaleMap> &maps2 )
+{
+    if ( maps1.size() != maps2.size() )
+        return false;
+
+    for ( int i = 0; i < maps1.size(); i++ )
+    {
+        const QwtScaleMap &m1 = maps1[i];
+        const QwtScaleMap &m2 = maps2[i];
+
+        if ( m1.s1() != m2.s1() || m1.s2() != m2.s2()
+            || m1.p1() != m2.p1() || m1.p2() != m2.p2() )
+        {
+            return false;
+        }
+
+        // catching a change of the transformation, f.e. linear -> log
+        const double s = 0.5 * ( m1.s1() + m1.s2() );
+        if ( m1.transform( s ) != m2.transform( s ) )
+            return false;
+    }
+
+    return true;
+}
 
 class QwtPlotCanvas::PrivateData
 {
@@ -55,7 +151,11 @@ public:
 #ifndef QWT_NO_OPENGL
         surfaceGL( NULL ),
 #endif
-        backingStore( NULL )
+        backingStore( NULL ),
+        frameWatcher( NULL ),
+        framePending( false ),
+        hasFrame( false ),
+        frameClearsLayers( true )
     {
     }
 
@@ -75,6 +175,30 @@ public:
 #endif
 
     QPixmap *backingStore;
+
+    // images of the layers > 0, that are composed on top of the backing store
+    QMap<int, QPixmap> layers;
+
+    // layers of the items, that have been changed since the last replot
+    QList<int> dirtyLayers;
+
+    // scale maps of the last replot
+    QVector<QwtScaleMap> maps;
+
+#if QWT_USE_THREADS
+    QFutureWatcher<QImage> *frameWatcher;
+#else
+    void *frameWatcher;
+#endif
+
+    // a replot has been requested, while a frame was rendered
+    bool framePending;
+
+    // the frame has not been applied to the backing store yet
+    bool hasFrame;
+
+    // the layers > 0 are outdated, when the frame has been swapped
+    bool frameClearsLayers;
 };
 
 /*!
@@ -97,6 +221,7 @@ QwtPlotCanvas::QwtPlotCanvas( QwtPlot *plot ):
 //! Destructor
 QwtPlotCanvas::~QwtPlotCanvas()
 {
+    waitForFrame();
     delete d_data;
 }
 
@@ -151,6 +276,29 @@ void QwtPlotCanvas::setPaintAttribute( PaintAttribute attribute, bool on )
 
             break;
         }
+        case LayeredBackingStore:
+        {
+            invalidateBackingStore();
+            break;
+        }
+        case AsyncRendering:
+        {
+#if QWT_USE_THREADS
+            if ( on && d_data->frameWatcher == NULL )
+            {
+                d_data->frameWatcher = new QFutureWatcher<QImage>( this );
+                connect( d_data->frameWatcher, SIGNAL(finished()),
+                    this, SLOT(swapFrame()) );
+            }
+#endif
+            if ( !on )
+            {
+                waitForFrame();
+                d_data->framePending = false;
+                d_data->hasFrame = false;
+            }
+            break;
+        }
         default:
         {
             break;
@@ -176,11 +324,61 @@ const QPixmap *QwtPlotCanvas::backingStore() const
     return d_data->backingStore;
 }
 
-//! Invalidate the internal backing store
+//! Invalidate the internal backing store including all layers
 void QwtPlotCanvas::invalidateBackingStore()
 {
     if ( d_data->backingStore )
         *d_data->backingStore = QPixmap();
+
+    d_data->layers.clear();
+}
+
+/*!
+  \brief Invalidate the image of a layer
+
+  For layers <= 0 the backing store is invalidated, while
+  the images of the layers on top of it are kept.
+
+  \param layer Layer
+  \sa LayeredBackingStore, replotLayer(), invalidateBackingStore()
+*/
+void QwtPlotCanvas::invalidateLayer( int layer )
+{
+    if ( layer <= 0 )
+    {
+        if ( d_data->backingStore )
+            *d_data->backingStore = QPixmap();
+    }
+    else
+    {
+        QMap<int, QPixmap>::iterator it = d_data->layers.find( layer );
+        if ( it != d_data->layers.end() )
+            it.value() = QPixmap();
+    }
+}
+
+/*!
+  \brief Mark a layer as outdated
+
+  When LayeredBackingStore is enabled the next replot() invalidates only
+  the images of the layers, that have been marked, unless the scale maps
+  have been changed. Without any marked layer replot() invalidates
+  all of them.
+
+  QwtPlotItem::itemChanged() marks the layer of the item.
+
+  \note Changes, that are not indicated by QwtPlotItem::itemChanged(),
+        f.e. samples modified in place, need to be followed by
+        invalidateLayer() or QwtPlotItem::itemChanged().
+
+  \param layer Layer, values < 0 are treated like 0
+  \sa replot(), invalidateLayer(), QwtPlotItem::renderLayer()
+*/
+void QwtPlotCanvas::markLayerDirty( int layer )
+{
+    layer = qMax( layer, 0 );
+    if ( !d_data->dirtyLayers.contains( layer ) )
+        d_data->dirtyLayers += layer;
 }
 
 /*!
@@ -218,17 +416,34 @@ bool QwtPlotCanvas::event( QEvent *event )
 */
 void QwtPlotCanvas::paintEvent( QPaintEvent *event )
 {
+    QwtPlotProfiler *profiler = plot() ? plot()->profiler() : NULL;
+
+    QElapsedTimer timer;
+    if ( profiler )
+        timer.start();
+
     QPainter painter( this );
     painter.setClipRegion( event->region() );
 
     if ( testPaintAttribute( QwtPlotCanvas::BackingStore ) &&
         d_data->backingStore != NULL )
     {
+        // the backing store contains the items of layer 0 only
+        const bool doLayers = testPaintAttribute( LayeredBackingStore );
+
         QPixmap &bs = *d_data->backingStore;
         if ( bs.size() != size() * QwtPainter::devicePixelRatio( &bs ) )
         {
+            // the items must not be painted from 2 threads at the same time
+            waitForFrame();
+
+            // the frame is outdated by the items painted now
+            d_data->hasFrame = false;
+
             bs = QwtPainter::backingStore( this, size() );
 
+            setLayerFilter( doLayers, 0 );
+
 #ifndef QWT_NO_OPENGL
             if ( testPaintAttribute( OpenGLBuffer ) )
             {
@@ -261,9 +476,31 @@ void QwtPlotCanvas::paintEvent( QPaintEvent *event )
                 if ( frameWidth() > 0 )
                     drawBorder( &p );
             }
+
+            setLayerFilter( false );
         }
 
+        if ( doLayers )
+            updateLayers();
+
+        const qint64 blitStart = profiler ? timer.nsecsElapsed() : 0;
+
         painter.drawPixmap( 0, 0, *d_data->backingStore );
+
+        if ( doLayers )
+        {
+            for ( QMap<int, QPixmap>::const_iterator it = d_data->layers.constBegin();
+                it != d_data->layers.constEnd(); ++it )
+            {
+                painter.drawPixmap( 0, 0, it.value() );
+            }
+        }
+
+        if ( profiler )
+        {
+            profiler->phaseFinished( QwtPlotProfiler::BackingStore,
+                timer.nsecsElapsed() - blitStart );
+        }
     }
     else
     {
@@ -322,6 +559,12 @@ void QwtPlotCanvas::paintEvent( QPaintEvent *event )
 
     if ( hasFocus() && focusIndicator() == CanvasFocusIndicator )
         drawFocusIndicator( &painter );
+
+    if ( profiler )
+    {
+        profiler->phaseFinished( QwtPlotProfiler::CanvasPaint,
+            timer.nsecsElapsed() );
+    }
 }
 
 /*!
@@ -355,11 +598,101 @@ void QwtPlotCanvas::resizeEvent( QResizeEvent *event )
 
 /*!
    Invalidate the paint cache and repaint the canvas
-   \sa invalidatePaintCache()
+
+   With LayeredBackingStore only the layers marked by markLayerDirty()
+   are invalidated, as long as the scale maps have not been changed.
+   With AsyncRendering the items are rendered in a background thread
+   and the canvas is repainted when the frame is finished.
+
+   \sa invalidatePaintCache(), markLayerDirty(), AsyncRendering
 */
 void QwtPlotCanvas::replot()
 {
-    invalidateBackingStore();
+    if ( isRenderingFrame() )
+    {
+        // the frame in progress is outdated
+        d_data->framePending = true;
+        return;
+    }
+
+#if QWT_USE_THREADS
+    if ( d_data->hasFrame )
+    {
+        /*
+            The frame has been finished by waitForFrame(), but the
+            notification has not been delivered yet. Displaying it now
+            keeps the canvas updating, even when the next frame
+            is started before.
+         */
+        applyFrame();
+    }
+#endif
+
+    const QList<int> dirtyLayers = d_data->dirtyLayers;
+    d_data->dirtyLayers.clear();
+
+    const QVector<QwtScaleMap> maps = qwtCanvasMaps( plot() );
+    const bool isRescaled = !qwtIsSameMaps( maps, d_data->maps );
+    d_data->maps = maps;
+
+    const bool isPartial = testPaintAttribute( BackingStore )
+        && testPaintAttribute( LayeredBackingStore )
+        && !isRescaled && !dirtyLayers.isEmpty();
+
+    if ( isPartial )
+    {
+        for ( int i = 0; i < dirtyLayers.size(); i++ )
+        {
+            // layer 0 might be rendered in the background
+            if ( dirtyLayers[i] > 0 )
+                invalidateLayer( dirtyLayers[i] );
+        }
+
+        if ( !dirtyLayers.contains( 0 ) )
+        {
+            if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+                repaint( contentsRect() );
+            else
+                update( contentsRect() );
+
+            return;
+        }
+    }
+
+    d_data->frameClearsLayers = !isPartial;
+    if ( startFrame() )
+        return;
+
+    if ( isPartial )
+        invalidateLayer( 0 );
+    else
+        invalidateBackingStore();
+
+    if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+        repaint( contentsRect() );
+    else
+        update( contentsRect() );
+}
+
+/*!
+   \brief Repaint the items of a layer
+
+   When LayeredBackingStore is enabled only the image of the layer
+   is rendered again, otherwise replotLayer() is the same as replot().
+
+   \param layer Layer
+   \sa invalidateLayer(), QwtPlotItem::setRenderLayer()
+*/
+void QwtPlotCanvas::replotLayer( int layer )
+{
+    if ( !( testPaintAttribute( BackingStore )
+        && testPaintAttribute( LayeredBackingStore ) ) )
+    {
+        replot();
+        return;
+    }
+
+    invalidateLayer( layer );
 
     if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
         repaint( contentsRect() );
@@ -367,6 +700,356 @@ void QwtPlotCanvas::replot()
         update( contentsRect() );
 }
 
+void QwtPlotCanvas::updateLayers()
+{
+    QMap<int, QPixmap> layers;
+
+    if ( const QwtPlot *plt = plot() )
+    {
+        const QwtPlotItemList& itmList = plt->itemList();
+        for ( QwtPlotItemIterator it = itmList.begin();
+            it != itmList.end(); ++it )
+        {
+            const QwtPlotItem *item = *it;
+
+            const int layer = item->renderLayer();
+            if ( layer > 0 && item->isVisible() && !layers.contains( layer ) )
+                layers.insert( layer, d_data->layers.value( layer ) );
+        }
+    }
+
+    for ( QMap<int, QPixmap>::iterator it = layers.begin();
+        it != layers.end(); ++it )
+    {
+        QPixmap &pm = it.value();
+        if ( pm.size() != size() * QwtPainter::devicePixelRatio( &pm ) )
+        {
+            pm = QwtPainter::backingStore( this, size() );
+            pm.fill( Qt::transparent );
+
+            QPainter p( &pm );
+
+            setLayerFilter( true, it.key() );
+            drawCanvas( &p );
+            setLayerFilter( false );
+        }
+    }
+
+    d_data->layers = layers;
+}
+
+/*!
+   \return true, when a frame is rendered in a background thread
+   \sa AsyncRendering, waitForFrame()
+*/
+bool QwtPlotCanvas::isRenderingFrame() const
+{
+#if QWT_USE_THREADS
+    if ( d_data->frameWatcher )
+        return d_data->frameWatcher->isRunning();
+#endif
+
+    return false;
+}
+
+/*!
+   \brief Block until the frame, that is rendered in a background thread,
+          has been finished
+
+   The result is applied later, when the event loop delivers
+   the notification of the background thread.
+
+   \sa AsyncRendering, isRenderingFrame()
+*/
+void QwtPlotCanvas::waitForFrame()
+{
+#if QWT_USE_THREADS
+    if ( d_data->frameWatcher )
+        d_data->frameWatcher->waitForFinished();
+#endif
+}
+
+/*!
+   \brief Start rendering the plot items in a background thread
+
+   The backing store is used to display the previous frame
+   until the new one has been rendered.
+
+   \return false, when the canvas has to be rendered synchronously
+*/
+bool QwtPlotCanvas::startFrame()
+{
+#if QWT_USE_THREADS
+    if ( !testPaintAttribute( AsyncRendering )
+        || d_data->frameWatcher == NULL || d_data->backingStore == NULL )
+    {
+        return false;
+    }
+
+    // the first frame, and frames after resizing, are rendered synchronously
+    const QPixmap &bs = *d_data->backingStore;
+    if ( bs.isNull() || bs.size() != size() * QwtPainter::devicePixelRatio( &bs ) )
+        return false;
+
+    // the background and border depend on the style, what is GUI thread only
+    if ( testAttribute( Qt::WA_StyledBackground ) || borderRadius() > 0.0 )
+        return false;
+
+#ifndef QWT_NO_OPENGL
+    if ( testPaintAttribute( OpenGLBuffer ) )
+        return false;
+#endif
+
+    QwtPlot *plt = plot();
+    if ( plt == NULL )
+        return false;
+
+    FrameCommand command;
+    command.plot = plt;
+    command.size = size();
+    command.pixelRatio = QwtPainter::devicePixelRatio( this );
+    command.contentsRect = contentsRect();
+    command.doLayers = testPaintAttribute( LayeredBackingStore );
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        command.maps[axisId] = plt->canvasMap( axisId );
+
+    d_data->framePending = false;
+    d_data->hasFrame = true;
+    d_data->frameWatcher->setFuture(
+        QtConcurrent::run( &qwtRenderFrame, command ) );
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+   \brief Display the frame, that has been rendered in the background
+
+   When the plot has been changed in the meantime the frame is
+   displayed nevertheless and the next one is started.
+*/
+void QwtPlotCanvas::swapFrame()
+{
+#if QWT_USE_THREADS
+    if ( d_data->frameWatcher == NULL || !testPaintAttribute( AsyncRendering ) )
+        return;
+
+    // the frame might have been applied already, when a new one was started
+    if ( !d_data->hasFrame || isRenderingFrame() )
+        return;
+
+    applyFrame();
+
+    if ( d_data->framePending )
+    {
+        d_data->framePending = false;
+
+        // the scales might have been changed too
+        QwtPlot *plt = plot();
+        if ( plt )
+            plt->replot();
+        else
+            replot();
+    }
+#endif
+}
+
+void QwtPlotCanvas::applyFrame()
+{
+#if QWT_USE_THREADS
+    d_data->hasFrame = false;
+
+    const QImage image = d_data->frameWatcher->result();
+
+    if ( d_data->backingStore == NULL ||
+        image.size() != size() * QwtPainter::devicePixelRatio( &image ) )
+    {
+        // the canvas has been resized and repainted synchronously
+        return;
+    }
+
+    QPixmap &bs = *d_data->backingStore;
+    bs = QwtPainter::backingStore( this, size() );
+
+    QwtPainter::fillPixmap( this, bs );
+
+    QPainter painter( &bs );
+    painter.drawImage( 0, 0, image );
+
+    if ( frameWidth() > 0 )
+        drawBorder( &painter );
+
+    painter.end();
+
+    if ( d_data->frameClearsLayers )
+        d_data->layers.clear();
+
+    if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+        repaint( contentsRect() );
+    else
+        update( contentsRect() );
+#endif
+}
+
+/*!
+   \brief Shift the backing store and repaint the exposed strips only
+
+   After panning the scales by a pixel offset most of the previous
+   frame is still valid. scrollBackingStore() moves the backing store,
+   and the images of the layers, by dx/dy and renders the items
+   clipped to the strips, that have been shifted into the canvas.
+
+   This is only possible, when all visible items have the
+   QwtPlotItem::Scrollable attribute and the canvas has a
+   plain background. Otherwise nothing happens and false is returned,
+   so that the caller can fall back to replot().
+
+   \param dx Offset in horizontal direction
+   \param dy Offset in vertical direction
+   \return true, when the backing store has been shifted
+
+   \note The scales of the plot need to be updated before
+   \sa QwtPlotPanner::moveCanvas(), QwtPlotItem::Scrollable
+*/
+bool QwtPlotCanvas::scrollBackingStore( int dx, int dy )
+{
+    if ( !testPaintAttribute( BackingStore ) || d_data->backingStore == NULL )
+        return false;
+
+    // the backing store is outdated, when a frame is in progress
+    if ( isRenderingFrame() )
+        return false;
+
+    const QPixmap &bs = *d_data->backingStore;
+    if ( bs.isNull() || bs.size() != size() * QwtPainter::devicePixelRatio( &bs ) )
+        return false;
+
+    if ( testAttribute( Qt::WA_StyledBackground ) || borderRadius() > 0.0 )
+        return false;
+
+#ifndef QWT_NO_OPENGL
+    if ( testPaintAttribute( OpenGLBuffer ) )
+        return false;
+#endif
+
+    // a gradient or a texture would be shifted together with the items
+    if ( palette().brush( backgroundRole() ).style() != Qt::SolidPattern )
+        return false;
+
+    const QRect cr = contentsRect();
+    if ( qAbs( dx ) >= cr.width() || qAbs( dy ) >= cr.height() )
+        return false;
+
+    const QwtPlot *plt = plot();
+    if ( plt == NULL )
+        return false;
+
+    const QwtPlotItemList& itmList = plt->itemList();
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+        if ( item->isVisible() &&
+            !item->testItemAttribute( QwtPlotItem::Scrollable ) )
+        {
+            return false;
+        }
+    }
+
+    if ( dx == 0 && dy == 0 )
+        return true;
+
+    const bool doLayers = testPaintAttribute( LayeredBackingStore );
+
+    scrollPixmap( *d_data->backingStore, dx, dy, doLayers, 0 );
+
+    for ( QMap<int, QPixmap>::iterator it = d_data->layers.begin();
+        it != d_data->layers.end(); ++it )
+    {
+        // outdated layers are rendered completely in updateLayers()
+        QPixmap &pm = it.value();
+        if ( pm.size() == size() * QwtPainter::devicePixelRatio( &pm ) )
+            scrollPixmap( pm, dx, dy, true, it.key() );
+    }
+
+    // the images are valid for the scale maps after panning
+    d_data->maps = qwtCanvasMaps( plt );
+
+    if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+        repaint( cr );
+    else
+        update( cr );
+
+    return true;
+}
+
+void QwtPlotCanvas::scrollPixmap( QPixmap &pixmap,
+    int dx, int dy, bool doLayers, int layer )
+{
+    const QRect cr = contentsRect();
+
+    QPixmap pm = QwtPainter::backingStore( this, size() );
+    if ( layer > 0 )
+        pm.fill( Qt::transparent );
+    else
+        QwtPainter::fillPixmap( this, pm );
+
+    QPainter painter( &pm );
+
+    painter.save();
+    painter.setClipRect( cr );
+    painter.drawPixmap( dx, dy, pixmap );
+    painter.restore();
+
+    // the strips, that have been shifted into the canvas
+
+    QRect strips[2];
+
+    if ( dx > 0 )
+        strips[0] = QRect( cr.left(), cr.top(), dx, cr.height() );
+    else if ( dx < 0 )
+        strips[0] = QRect( cr.right() + 1 + dx, cr.top(), -dx, cr.height() );
+
+    if ( dy > 0 )
+        strips[1] = QRect( cr.left(), cr.top(), cr.width(), dy );
+    else if ( dy < 0 )
+        strips[1] = QRect( cr.left(), cr.bottom() + 1 + dy, cr.width(), -dy );
+
+    if ( dy != 0 )
+    {
+        // the corner must not be painted twice
+        if ( dx > 0 )
+            strips[1].setLeft( strips[1].left() + dx );
+        else if ( dx < 0 )
+            strips[1].setRight( strips[1].right() + dx );
+    }
+
+    setLayerFilter( doLayers, layer );
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        if ( strips[i].isValid() )
+        {
+            painter.save();
+            painter.setClipRect( strips[i] );
+            drawCanvas( &painter );
+            painter.restore();
+        }
+    }
+
+    setLayerFilter( false );
+
+    if ( layer == 0 && frameWidth() > 0 )
+        drawBorder( &painter );
+
+    painter.end();
+
+    pixmap = pm;
+}
+
 /*!
    Calculate the painter path for a styled or rounded border
 
@@ -123,7 +123,58 @@ public:
 
           \sa QwtPlotOpenGLCanvas, QwtPlotGLCanvas
          */
-        OpenGLBuffer = 16
+        OpenGLBuffer = 16,
+
+        /*!
+          \brief Split the backing store into layers
+
+          The items of each QwtPlotItem::renderLayer() > 0 are cached in
+          an image of their own, that is composed on top of the backing store.
+          replotLayer() repaints the items of one layer only, while
+          the images of all other layers are reused. replot() does the
+          same for the layers of the items, that have been changed
+          by QwtPlotItem::itemChanged(), as long as the scale maps
+          are unchanged. This is useful
+          for frequently updated items ( f.e. a live curve or a marker )
+          on top of items, that are expensive to render
+          ( f.e. a spectrogram ).
+
+          LayeredBackingStore has no effect without BackingStore.
+
+          \sa replotLayer(), invalidateLayer(), markLayerDirty(),
+              QwtPlotItem::setRenderLayer()
+         */
+        LayeredBackingStore = 32,
+
+        /*!
+          \brief Render the plot items in a background thread
+
+          replot() takes a snapshot of the scale maps and renders the
+          items by QwtPlot::drawItems() into a QImage in a worker thread.
+          Meanwhile the previous frame remains visible and the GUI thread
+          stays responsive. When QwtPlot::replot() is called again before
+          the frame is finished, updating the axes is deferred until the
+          frame is done. Then the frame is displayed and the
+          replot is repeated, so that the canvas keeps being updated
+          even when replots are requested faster than frames are
+          rendered.
+
+          Overloaded QwtPlot::drawItems() and the hooks of a
+          QwtPlotProfiler are called from the worker thread then.
+
+          The first frame, and frames after a resize, are painted
+          synchronously. AsyncRendering has no effect without BackingStore,
+          with styled backgrounds, rounded borders or OpenGLBuffer.
+
+          Modifying a plot item waits for the frame in progress:
+          QwtPlotItem::itemChanged() and replacing the samples of a
+          QwtPlotSeriesItem block until the frame has been finished.
+          Samples, that are modified in place by the application,
+          have to be protected by waitForFrame().
+
+          \sa isRenderingFrame(), waitForFrame()
+         */
+        AsyncRendering = 64
     };
 
     //! Paint attributes
@@ -137,6 +188,13 @@ public:
 
     const QPixmap *backingStore() const;
     Q_INVOKABLE void invalidateBackingStore();
+    Q_INVOKABLE void invalidateLayer( int layer );
+    void markLayerDirty( int layer );
+
+    bool isRenderingFrame() const;
+    Q_INVOKABLE void waitForFrame();
+
+    Q_INVOKABLE bool scrollBackingStore( int dx, int dy );
 
     virtual bool event( QEvent * ) QWT_OVERRIDE;
 
@@ -144,6 +202,7 @@ public:
 
 public Q_SLOTS:
     void replot();
+    void replotLayer( int layer );
 
 protected:
     virtual void paintEvent( QPaintEvent * ) QWT_OVERRIDE;
@@ -151,9 +210,18 @@ protected:
 
     virtual void drawBorder( QPainter * ) QWT_OVERRIDE;
 
+private Q_SLOTS:
+    void swapFrame();
+
 private:
     QImage toImageFBO( const QSize &size );
 
+    void updateLayers();
+    bool startFrame();
+    void applyFrame();
+
+    void scrollPixmap( QPixmap &, int dx, int dy, bool doLayers, int layer );
+
     class PrivateData;
     PrivateData *d_data;
 };
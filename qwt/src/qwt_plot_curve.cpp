@@ -9,11 +9,14 @@
 
 #include "qwt_plot_curve.h"
 #include "qwt_point_data.h"
+#include "qwt_pyramid_point_data.h"
+#include "qwt_point_index.h"
 #include "qwt_math.h"
 #include "qwt_clipper.h"
 #include "qwt_painter.h"
 #include "qwt_scale_map.h"
 #include "qwt_plot.h"
+#include "qwt_plot_profiler.h"
 #include "qwt_spline_curve_fitter.h"
 #include "qwt_symbol.h"
 #include "qwt_point_mapper.h"
@@ -21,6 +24,8 @@
 #include "qwt_graphic.h"
 
 #include <qpainter.h>
+#include <qpaintengine.h>
+#include <qimage.h>
 
 static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *painter )
 {
@@ -38,6 +43,23 @@ static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *paint
     return clipRect;
 }
 
+static inline void qwtInvalidateFitter( QwtCurveFitter *fitter )
+{
+    QwtSplineCurveFitter *splineFitter =
+        dynamic_cast< QwtSplineCurveFitter * >( fitter );
+
+    if ( splineFitter )
+        splineFitter->invalidateCache();
+}
+
+static inline void qwtReportSamples( const QwtPlotItem *item,
+    int numSamples, int numPoints )
+{
+    const QwtPlot *plot = item->plot();
+    if ( plot && plot->profiler() )
+        plot->profiler()->samplesMapped( item, numSamples, numPoints );
+}
+
 static void qwtUpdateLegendIconSize( QwtPlotCurve *curve )
 {
     if ( curve->symbol() &&
@@ -75,6 +97,85 @@ static int qwtVerifyRange( int size, int &i1, int &i2 )
     return ( i2 - i1 + 1 );
 }
 
+namespace
+{
+    struct compareX
+    {
+        inline bool operator()( const double x, const QPointF &pos ) const
+        {
+            return ( x < pos.x() );
+        }
+    };
+}
+
+static void qwtVisibleRange( const QwtSeriesData<QPointF> &series,
+    double x1, double x2, int &from, int &to )
+{
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    const int numSamples = static_cast<int>( series.size() );
+
+    // first sample right of x1 and one sample of overhang
+    int index1 = qwtUpperSampleIndex<QPointF>( series, x1, compareX() );
+    if ( index1 < 0 )
+        index1 = numSamples - 1;
+    else
+        index1 = qMax( index1 - 1, 0 );
+
+    // first sample right of x2 is the overhang
+    int index2 = qwtUpperSampleIndex<QPointF>( series, x2, compareX() );
+    if ( index2 < 0 )
+        index2 = numSamples - 1;
+
+    from = qMax( from, index1 );
+    to = qMin( to, index2 );
+}
+
+static bool qwtUseAppendCache( const QPainter *painter )
+{
+    if ( !QwtPainter::roundingAlignment( painter ) )
+        return false;
+
+    switch( painter->paintEngine()->type() )
+    {
+        case QPaintEngine::Picture:
+        case QPaintEngine::User: // usually QwtGraphic
+        {
+            // don't use a cache for record/replay devices
+            return false;
+        }
+        default:;
+    }
+
+    const QTransform &transform = painter->transform();
+    return !( transform.isScaling() || transform.isRotating() );
+}
+
+static inline bool qwtIsSameMap( const QwtScaleMap &map1,
+    const QwtScaleMap &map2 )
+{
+    if ( map1.s1() != map2.s1() || map1.s2() != map2.s2()
+        || map1.p1() != map2.p1() || map1.p2() != map2.p2() )
+    {
+        return false;
+    }
+
+    // probing for the same type of transformation
+    const double s = 0.5 * ( map1.s1() + map1.s2() );
+    return map1.transform( s ) == map2.transform( s );
+}
+
+static inline bool qwtIsScrolledMap( const QwtScaleMap &map1,
+    const QwtScaleMap &map2 )
+{
+    if ( map1.transformation() || map2.transformation() )
+        return false;
+
+    return map1.p1() == map2.p1() && map1.p2() == map2.p2()
+        && qFuzzyCompare( map1.s2() - map1.s1(), map2.s2() - map2.s1() );
+}
+
 class QwtPlotCurve::PrivateData
 {
 public:
@@ -86,13 +187,18 @@ public:
         attributes( 0 ),
         paintAttributes(
             QwtPlotCurve::ClipPolygons | QwtPlotCurve::FilterPoints ),
-        legendAttributes( 0 )
+        legendAttributes( 0 ),
+        pointIndex( NULL )
     {
         curveFitter = new QwtSplineCurveFitter;
+
+        report.isAccumulating = false;
+        report.numSamples = report.numPoints = 0;
     }
 
     ~PrivateData()
     {
+        delete pointIndex;
         delete symbol;
         delete curveFitter;
     }
@@ -110,6 +216,66 @@ public:
     QwtPlotCurve::PaintAttributes paintAttributes;
 
     QwtPlotCurve::LegendAttributes legendAttributes;
+
+    QwtPointIndex *pointIndex;
+
+    class PaintCache
+    {
+    public:
+        PaintCache():
+            numSamples( 0 ),
+            pixelRatio( 1.0 ),
+            style( QwtPlotCurve::NoCurve ),
+            symbol( NULL ),
+            baseline( 0.0 ),
+            orientation( Qt::Vertical )
+        {
+        }
+
+        QImage image;
+        QRect rect;
+
+        // the maps, that correspond to the image
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
+
+        int numSamples;
+
+        // properties, that have been used for rendering the image
+        qreal pixelRatio;
+        QPainter::RenderHints renderHints;
+        QPen pen;
+        QwtPlotCurve::CurveStyle style;
+        const QwtSymbol *symbol;
+        QwtPlotCurve::CurveAttributes attributes;
+        QwtPlotCurve::PaintAttributes paintAttributes;
+        double baseline;
+        Qt::Orientation orientation;
+
+    } cache;
+
+    void reportSamples( const QwtPlotItem *item,
+        int numSamples, int numPoints )
+    {
+        if ( report.isAccumulating )
+        {
+            report.numSamples += numSamples;
+            report.numPoints += numPoints;
+        }
+        else
+        {
+            qwtReportSamples( item, numSamples, numPoints );
+        }
+    }
+
+    // summing up the partial draws of drawCached()
+    struct SampleReport
+    {
+        bool isAccumulating;
+        int numSamples;
+        int numPoints;
+
+    } report;
 };
 
 /*!
@@ -143,6 +309,7 @@ void QwtPlotCurve::init()
 {
     setItemAttribute( QwtPlotItem::Legend );
     setItemAttribute( QwtPlotItem::AutoScale );
+    setItemAttribute( QwtPlotItem::Scrollable );
 
     d_data = new PrivateData;
     setData( new QwtPointSeriesData() );
@@ -180,6 +347,75 @@ bool QwtPlotCurve::testPaintAttribute( PaintAttribute attribute ) const
     return ( d_data->paintAttributes & attribute );
 }
 
+/*!
+   Invalidate the image of the AppendCache and the point index
+
+   The image is rebuilt from all samples, when the
+   curve is painted the next time. The point index is rebuilt
+   with the next lookup.
+
+   \sa AppendCache, setPaintAttribute(), setPointIndexEnabled()
+*/
+void QwtPlotCurve::invalidateCache()
+{
+    waitForFrame();
+
+    d_data->cache.image = QImage();
+    d_data->cache.numSamples = 0;
+
+    if ( d_data->pointIndex )
+        d_data->pointIndex->clear();
+
+    qwtInvalidateFitter( d_data->curveFitter );
+}
+
+/*!
+   \brief En/Disable a spatial index for closestPoint()
+
+   Without an index closestPoint() iterates over all samples, or when
+   MonotonicX is enabled, starts at the sample found by a binary search.
+
+   The index is built with the next lookup and needs additional memory
+   for a copy of the sample positions. Samples, that have been appended
+   later, are added incrementally. When samples are modified in place
+   invalidateCache() has to be called.
+
+   \param on On/Off
+   \sa isPointIndexEnabled(), closestPoint(), QwtPointIndex
+*/
+void QwtPlotCurve::setPointIndexEnabled( bool on )
+{
+    if ( on == isPointIndexEnabled() )
+        return;
+
+    if ( on )
+    {
+        d_data->pointIndex = new QwtPointIndex();
+    }
+    else
+    {
+        delete d_data->pointIndex;
+        d_data->pointIndex = NULL;
+    }
+}
+
+/*!
+   \return True, when a spatial index is used for closestPoint()
+   \sa setPointIndexEnabled()
+*/
+bool QwtPlotCurve::isPointIndexEnabled() const
+{
+    return d_data->pointIndex != NULL;
+}
+
+//! Invalidate the cached image, the point index and update the plot
+void QwtPlotCurve::dataChanged()
+{
+    invalidateCache();
+
+    QwtPlotSeriesItem::dataChanged();
+}
+
 /*!
   Specify an attribute how to draw the legend icon
 
@@ -276,6 +512,8 @@ void QwtPlotCurve::setSymbol( QwtSymbol *symbol )
 {
     if ( symbol != d_data->symbol )
     {
+        waitForFrame();
+
         delete d_data->symbol;
         d_data->symbol = symbol;
 
@@ -385,6 +623,9 @@ const QBrush& QwtPlotCurve::brush() const
   \param to Index of the last point to be painted. If to < 0 the
          curve will be painted to its last point.
 
+  \note When MonotonicX is enabled the interval is reduced to the
+        samples inside of the visible area.
+
   \sa drawCurve(), drawSymbols(),
 */
 void QwtPlotCurve::drawSeries( QPainter *painter,
@@ -396,9 +637,36 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
     if ( !painter || numSamples <= 0 )
         return;
 
+    if ( ( d_data->paintAttributes & AppendCache ) && from == 0 && to < 0 )
+    {
+        if ( drawCached( painter, xMap, yMap, canvasRect ) )
+            return;
+    }
+
     if ( to < 0 )
         to = numSamples - 1;
 
+    if ( ( d_data->paintAttributes & MonotonicX ) && canvasRect.isValid() )
+    {
+        // also samples slightly outside might be visible because
+        // of the pen width or the size of the symbol
+
+        double margin = QwtPainter::effectivePenWidth( d_data->pen );
+        if ( d_data->symbol &&
+            ( d_data->symbol->style() != QwtSymbol::NoSymbol ) )
+        {
+            const QRect br = d_data->symbol->boundingRect();
+            margin = qMax( margin, 0.5 * qMax( br.width(), br.height() ) );
+        }
+
+        const double x1 = xMap.invTransform( canvasRect.left() - margin );
+        const double x2 = xMap.invTransform( canvasRect.right() + margin );
+
+        qwtVisibleRange( *data(), x1, x2, from, to );
+        if ( from > to )
+            return;
+    }
+
     if ( qwtVerifyRange( numSamples, from, to ) > 0 )
     {
         painter->save();
@@ -424,6 +692,195 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
     }
 }
 
+/*!
+  \brief Draw the curve using the image of the AppendCache
+
+  Only samples, that have been appended since the last call are
+  rendered into the image - or the area, that has been exposed
+  by scrolling the x axis.
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+
+  \return false, when the cache can't be used
+  \sa AppendCache, invalidateCache()
+*/
+bool QwtPlotCurve::drawCached( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect ) const
+{
+    if ( ( d_data->brush.style() != Qt::NoBrush ) ||
+        ( d_data->style == Lines && testCurveAttribute( Fitted ) ) )
+    {
+        return false;
+    }
+
+    if ( !qwtUseAppendCache( painter ) )
+        return false;
+
+    PrivateData::PaintCache &cache = d_data->cache;
+
+    const int numSamples = static_cast<int>( dataSize() );
+    const QRect rect = canvasRect.toAlignedRect();
+
+#if QT_VERSION >= 0x050000
+    const qreal pixelRatio = QwtPainter::devicePixelRatio( painter->device() );
+#else
+    const qreal pixelRatio = 1.0;
+#endif
+
+    bool isValid = !cache.image.isNull()
+        && cache.rect == rect
+        && cache.numSamples <= numSamples
+        && cache.pixelRatio == pixelRatio
+        && cache.renderHints == painter->renderHints()
+        && cache.pen == d_data->pen
+        && cache.style == d_data->style
+        && cache.symbol == d_data->symbol
+        && cache.attributes == d_data->attributes
+        && cache.paintAttributes == d_data->paintAttributes
+        && cache.baseline == d_data->baseline
+        && cache.orientation == orientation()
+        && qwtIsSameMap( cache.yMap, yMap );
+
+    QRectF exposedRect;
+
+    if ( isValid && !qwtIsSameMap( cache.xMap, xMap ) )
+    {
+        isValid = false;
+
+        if ( ( d_data->paintAttributes & MonotonicX )
+            && qwtIsScrolledMap( cache.xMap, xMap ) )
+        {
+            // the distance in pixels, the x axis has been scrolled
+
+            const double dx = ( xMap.transform( cache.xMap.s1() )
+                - cache.xMap.p1() ) * pixelRatio;
+
+            const int shift = qRound( dx );
+
+            const double tolerance =
+                painter->testRenderHint( QPainter::Antialiasing ) ? 0.05 : 0.5;
+
+            if ( shift != 0 && qAbs( dx - shift ) <= tolerance
+                && qAbs( shift ) < cache.image.width() )
+            {
+                QImage image( cache.image.size(), cache.image.format() );
+#if QT_VERSION >= 0x050000
+                image.setDevicePixelRatio( pixelRatio );
+#endif
+                image.fill( Qt::transparent );
+
+                QPainter imagePainter( &image );
+                imagePainter.setCompositionMode( QPainter::CompositionMode_Source );
+                imagePainter.drawImage( QPointF( shift / pixelRatio, 0.0 ), cache.image );
+                imagePainter.end();
+
+                cache.image = image;
+
+                /*
+                   The image is not scrolled by the fraction of a pixel.
+                   So we adjust the map to the content of the image
+                 */
+
+                const double cnv = ( xMap.p2() - xMap.p1() )
+                    / ( xMap.s2() - xMap.s1() );
+                const double ds = ( dx - shift ) / pixelRatio / cnv;
+
+                cache.xMap = xMap;
+                cache.xMap.setScaleInterval( xMap.s1() + ds, xMap.s2() + ds );
+
+                const double w = qAbs( shift ) / pixelRatio;
+
+                if ( shift < 0 )
+                {
+                    exposedRect = QRectF( rect.right() + 1 - w,
+                        rect.top(), w, rect.height() );
+                }
+                else
+                {
+                    exposedRect = QRectF( rect.left(),
+                        rect.top(), w, rect.height() );
+                }
+
+                isValid = true;
+            }
+        }
+    }
+
+    if ( !isValid )
+    {
+        cache.image = QImage( rect.size() * pixelRatio,
+            QImage::Format_ARGB32_Premultiplied );
+#if QT_VERSION >= 0x050000
+        cache.image.setDevicePixelRatio( pixelRatio );
+#endif
+        cache.image.fill( Qt::transparent );
+
+        cache.rect = rect;
+        cache.xMap = xMap;
+        cache.yMap = yMap;
+        cache.numSamples = 0;
+
+        cache.pixelRatio = pixelRatio;
+        cache.renderHints = painter->renderHints();
+        cache.pen = d_data->pen;
+        cache.style = d_data->style;
+        cache.symbol = d_data->symbol;
+        cache.attributes = d_data->attributes;
+        cache.paintAttributes = d_data->paintAttributes;
+        cache.baseline = d_data->baseline;
+        cache.orientation = orientation();
+    }
+
+    // reporting the samples of the partial draws as one draw
+    PrivateData::SampleReport &report = d_data->report;
+    report.isAccumulating = true;
+    report.numSamples = report.numPoints = 0;
+
+    if ( exposedRect.isValid() || numSamples > cache.numSamples )
+    {
+        QPainter imagePainter( &cache.image );
+        imagePainter.setRenderHints( painter->renderHints() );
+        imagePainter.translate( -rect.topLeft() );
+
+        if ( exposedRect.isValid() && cache.numSamples > 0 )
+        {
+            imagePainter.save();
+            imagePainter.setClipRect( exposedRect );
+
+            drawSeries( &imagePainter, cache.xMap, cache.yMap,
+                exposedRect, 0, cache.numSamples - 1 );
+
+            imagePainter.restore();
+        }
+
+        if ( numSamples > cache.numSamples )
+        {
+            int from = cache.numSamples;
+            if ( from > 0 && ( d_data->style == Lines || d_data->style == Steps ) )
+            {
+                // connecting to the last sample, that has already been painted
+                from--;
+            }
+
+            drawSeries( &imagePainter, cache.xMap, cache.yMap,
+                canvasRect, from, numSamples - 1 );
+
+            cache.numSamples = numSamples;
+        }
+    }
+
+    report.isAccumulating = false;
+    qwtReportSamples( this, report.numSamples, report.numPoints );
+
+    painter->drawImage( rect.topLeft(), cache.image );
+
+    return true;
+}
+
 /*!
   \brief Draw the line part (without symbols) of a curve interval.
   \param painter Painter
@@ -472,6 +929,9 @@ void QwtPlotCurve::drawCurve( QPainter *painter, int style,
   If the CurveAttribute Fitted is enabled a QwtCurveFitter tries
   to interpolate/smooth the curve, before it is painted.
 
+  When the series is a QwtPyramidPointData only the first, minimal,
+  maximal and last sample of each pixel column are mapped and painted.
+
   \param painter Painter
   \param xMap x map
   \param yMap y map
@@ -489,6 +949,8 @@ void QwtPlotCurve::drawLines( QPainter *painter,
     if ( from > to )
         return;
 
+    const int numSamples = to - from + 1;
+
     const bool doFit = ( d_data->attributes & Fitted ) && d_data->curveFitter;
     const bool doAlign = !doFit && QwtPainter::roundingAlignment( painter );
     const bool doFill = ( d_data->brush.style() != Qt::NoBrush )
@@ -503,6 +965,36 @@ void QwtPlotCurve::drawLines( QPainter *painter,
         clipRect = clipRect.adjusted(-pw, -pw, pw, pw);
     }
 
+    if ( doFit && !doFill )
+    {
+        const QwtSplineCurveFitter *splineFitter =
+            dynamic_cast< const QwtSplineCurveFitter * >( d_data->curveFitter );
+
+        if ( splineFitter && splineFitter->isCacheEnabled() )
+        {
+            // the spline has been solved in plot coordinates before
+
+            QRectF r = clipRect;
+            if ( !( d_data->paintAttributes & ClipPolygons ) )
+            {
+                const qreal pw = QwtPainter::effectivePenWidth( painter->pen() );
+
+                r = qwtIntersectedClipRect( canvasRect, painter );
+                r = r.adjusted( -pw, -pw, pw, pw );
+            }
+
+            const QPainterPath path = splineFitter->mappedCurvePath(
+                data(), xMap, yMap, r );
+
+            d_data->reportSamples( this,
+                static_cast<int>( dataSize() ), path.elementCount() );
+
+            painter->drawPath( path );
+
+            return;
+        }
+    }
+
     bool doIntegers = false;
 
 #if QT_VERSION < 0x040800
@@ -537,10 +1029,30 @@ void QwtPlotCurve::drawLines( QPainter *painter,
 
     mapper.setBoundingRect( canvasRect );
 
+    const QwtSeriesData<QPointF> *series = data();
+
+    QwtPointSeriesData decimatedSeries;
+    if ( !doFit )
+    {
+        const QwtPyramidPointData *pyramid =
+            dynamic_cast< const QwtPyramidPointData * >( series );
+
+        QPolygonF samples;
+        if ( pyramid && pyramid->decimatedSamples( xMap, from, to, samples ) )
+        {
+            decimatedSeries.setSamples( samples );
+
+            series = &decimatedSeries;
+            from = 0;
+            to = samples.size() - 1;
+        }
+    }
+
     if ( doIntegers )
     {
         QPolygon polyline = mapper.toPolygon(
-            xMap, yMap, data(), from, to );
+            xMap, yMap, series, from, to );
+        d_data->reportSamples( this, numSamples, polyline.size() );
 
         if ( testPaintAttribute( ClipPolygons ) )
         {
@@ -551,7 +1063,8 @@ void QwtPlotCurve::drawLines( QPainter *painter,
     }
     else
     {
-        QPolygonF polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+        QPolygonF polyline = mapper.toPolygonF( xMap, yMap, series, from, to );
+        d_data->reportSamples( this, numSamples, polyline.size() );
 
         if ( doFill )
         {
@@ -665,6 +1178,8 @@ void QwtPlotCurve::drawSticks( QPainter *painter,
             QwtPainter::drawLine( painter, xi, y0, xi, yi );
     }
 
+    d_data->reportSamples( this, to - from + 1, to - from + 1 );
+
     painter->restore();
 }
 
@@ -714,6 +1229,7 @@ void QwtPlotCurve::drawDots( QPainter *painter,
 
         QPolygonF points = mapper.toPointsF(
             xMap, yMap, data(), from, to );
+        d_data->reportSamples( this, to - from + 1, points.size() );
 
         QwtPainter::drawPoints( painter, points );
         fillCurve( painter, xMap, yMap, canvasRect, points );
@@ -724,6 +1240,7 @@ void QwtPlotCurve::drawDots( QPainter *painter,
             data(), from, to, d_data->pen,
             painter->testRenderHint( QPainter::Antialiasing ),
             renderThreadCount() );
+        d_data->reportSamples( this, to - from + 1, to - from + 1 );
 
         painter->drawImage( canvasRect.toAlignedRect(), image );
     }
@@ -746,6 +1263,8 @@ void QwtPlotCurve::drawDots( QPainter *painter,
 
             QwtPainter::drawPoint( painter, QPointF( xi, yi ) );
         }
+
+        d_data->reportSamples( this, to - from + 1, to - from + 1 );
     }
     else
     {
@@ -753,6 +1272,7 @@ void QwtPlotCurve::drawDots( QPainter *painter,
         {
             const QPolygon points = mapper.toPoints(
                 xMap, yMap, data(), from, to );
+            d_data->reportSamples( this, to - from + 1, points.size() );
 
             QwtPainter::drawPoints( painter, points );
         }
@@ -760,6 +1280,7 @@ void QwtPlotCurve::drawDots( QPainter *painter,
         {
             const QPolygonF points = mapper.toPointsF(
                 xMap, yMap, data(), from, to );
+            d_data->reportSamples( this, to - from + 1, points.size() );
 
             QwtPainter::drawPoints( painter, points );
         }
@@ -829,6 +1350,8 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
         points[ip].ry() = yi;
     }
 
+    d_data->reportSamples( this, to - from + 1, polygon.size() );
+
     if ( d_data->paintAttributes & ClipPolygons )
     {
         QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
@@ -900,6 +1423,8 @@ bool QwtPlotCurve::testCurveAttribute( CurveAttribute attribute ) const
 */
 void QwtPlotCurve::setCurveFitter( QwtCurveFitter *curveFitter )
 {
+    waitForFrame();
+
     delete d_data->curveFitter;
     d_data->curveFitter = curveFitter;
 
@@ -1032,8 +1557,44 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
     const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
     mapper.setBoundingRect( clipRect );
 
+    if ( testPaintAttribute( QwtPlotCurve::ImageBuffer )
+        && QwtPainter::roundingAlignment( painter )
+        && !painter->transform().isScaling() )
+    {
+        const QRect rect = clipRect.toAlignedRect();
+
+        QImage image( rect.size(), QImage::Format_ARGB32_Premultiplied );
+        image.fill( 0 );
+
+        // the symbols are positioned with sub-pixel precision
+        mapper.setFlag( QwtPointMapper::RoundPoints, false );
+
+        const int chunkSize = 100000;
+
+        int numPoints = 0;
+        for ( int i = from; i <= to; i += chunkSize )
+        {
+            const int n = qMin( chunkSize, to - i + 1 );
+
+            QPolygonF points = mapper.toPointsF( xMap, yMap,
+                data(), i, i + n - 1 );
+            points.translate( -rect.topLeft() );
+
+            symbol.drawSymbols( &image, points.constData(), points.size(),
+                painter->renderHints(), renderThreadCount() );
+
+            numPoints += points.size();
+        }
+
+        painter->drawImage( rect.topLeft(), image );
+
+        d_data->reportSamples( this, to - from + 1, numPoints );
+        return;
+    }
+
     const int chunkSize = 500;
 
+    int numPoints = 0;
     for ( int i = from; i <= to; i += chunkSize )
     {
         const int n = qMin( chunkSize, to - i + 1 );
@@ -1043,7 +1604,11 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
 
         if ( points.size() > 0 )
             symbol.drawSymbols( painter, points );
+
+        numPoints += points.size();
     }
+
+    d_data->reportSamples( this, to - from + 1, numPoints );
 }
 
 /*!
@@ -1088,38 +1653,154 @@ double QwtPlotCurve::baseline() const
               the position and the closest curve point
   \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-  \note closestPoint() implements a dumb algorithm, that iterates
-        over all points
+
+  \note Without a point index or MonotonicX closestPoint() implements
+        a dumb algorithm, that iterates over all points
+
+  \sa setPointIndexEnabled(), closestPoints()
 */
 int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
 {
-    const size_t numSamples = dataSize();
-
-    if ( plot() == NULL || numSamples <= 0 )
+    if ( plot() == NULL || dataSize() <= 0 )
         return -1;
 
-    const QwtSeriesData<QPointF> *series = data();
+    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
+    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
+
+    return findClosestPoint( xMap, yMap, pos, dist );
+}
+
+/*!
+  Find the closest curve points for a couple of positions
+
+  \param positions Positions, where to look for the closest curve points
+  \param distances If distances != NULL, closestPoints() returns the distances
+                   between the positions and their closest curve points
+
+  \return Indexes of the closest curve points, or -1 if none can be found
+  \sa closestPoint(), setPointIndexEnabled()
+*/
+QVector<int> QwtPlotCurve::closestPoints(
+    const QPolygon &positions, QVector<double> *distances ) const
+{
+    QVector<int> indexes( positions.size(), -1 );
+
+    if ( distances )
+        distances->fill( 0.0, positions.size() );
+
+    if ( plot() == NULL || dataSize() <= 0 )
+        return indexes;
 
     const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
     const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
 
+    for ( int i = 0; i < positions.size(); i++ )
+    {
+        indexes[i] = findClosestPoint( xMap, yMap, positions[i],
+            distances ? distances->data() + i : NULL );
+    }
+
+    return indexes;
+}
+
+int QwtPlotCurve::findClosestPoint( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPointF &pos, double *dist ) const
+{
+    const QwtSeriesData<QPointF> *series = data();
+    const int numSamples = static_cast<int>( series->size() );
+
+    if ( d_data->pointIndex )
+    {
+        QwtPointIndex *pointIndex = d_data->pointIndex;
+
+        if ( pointIndex->size() > numSamples )
+            pointIndex->clear();
+
+        if ( pointIndex->size() < numSamples )
+        {
+            QwtSampleBlockReader<QPointF> reader(
+                series, pointIndex->size(), numSamples - 1 );
+
+            for ( int i = pointIndex->size(); i < numSamples; i++ )
+                pointIndex->append( reader.next() );
+        }
+
+        return pointIndex->closestPoint( xMap, yMap, pos, dist );
+    }
+
     int index = -1;
     double dmin = 1.0e10;
 
-    for ( uint i = 0; i < numSamples; i++ )
+    if ( d_data->paintAttributes & MonotonicX )
     {
-        const QPointF sample = series->sample( i );
+        /*
+            Starting at the samples left/right of pos we walk in both
+            directions, until the horizontal distance alone exceeds
+            the closest distance found so far.
+         */
+
+        int right = qwtUpperSampleIndex<QPointF>(
+            *series, xMap.invTransform( pos.x() ), compareX() );
+
+        if ( right < 0 )
+            right = numSamples;
+
+        for ( int i = right - 1; i >= 0; i-- )
+        {
+            const QPointF sample = series->sample( i );
+
+            const double cx = xMap.transform( sample.x() ) - pos.x();
+            if ( qwtSqr( cx ) >= dmin )
+                break;
+
+            const double cy = yMap.transform( sample.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
+        }
+
+        for ( int i = right; i < numSamples; i++ )
+        {
+            const QPointF sample = series->sample( i );
 
-        const double cx = xMap.transform( sample.x() ) - pos.x();
-        const double cy = yMap.transform( sample.y() ) - pos.y();
+            const double cx = xMap.transform( sample.x() ) - pos.x();
+            if ( qwtSqr( cx ) >= dmin )
+                break;
+
+            const double cy = yMap.transform( sample.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
+        }
+    }
+    else
+    {
+        QwtSampleBlockReader<QPointF> reader( series, 0, numSamples - 1 );
 
-        const double f = qwtSqr( cx ) + qwtSqr( cy );
-        if ( f < dmin )
+        for ( int i = 0; i < numSamples; i++ )
         {
-            index = i;
-            dmin = f;
+            const QPointF &sample = reader.next();
+
+            const double cx = xMap.transform( sample.x() ) - pos.x();
+            const double cy = yMap.transform( sample.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
         }
     }
+
     if ( dist )
         *dist = std::sqrt( dmin );
 
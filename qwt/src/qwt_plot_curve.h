@@ -21,6 +21,7 @@ class QwtCurveFitter;
 template <typename T> class QwtSeriesData;
 class QwtText;
 class QPainter;
+class QPolygon;
 class QPolygonF;
 class QPen;
 
@@ -125,6 +126,8 @@ public:
           for calculating coefficients and additional points.
           If painting in QwtPlotCurve::Fitted mode is slow it might be better
           to fit the points, before they are passed to QwtPlotCurve.
+          A QwtSplineCurveFitter with an enabled cache solves the spline
+          only once, when the data has been changed.
          */
         Fitted = 0x02
     };
@@ -204,6 +207,10 @@ public:
           having a huge amount of points.
           With a reasonable number of points QPainter::drawPoints()
           will be faster.
+
+          Symbols are also rendered to an image, when painting
+          to a raster device. Then they are blended from an atlas of
+          prerendered images - see QwtSymbol::drawSymbols().
          */
         ImageBuffer = 0x08,
 
@@ -230,6 +237,46 @@ public:
                 worked around by enabling the QwtPainter::polylineSplitting() mode.
          */
         FilterPointsAggressive = 0x10,
+
+        /*!
+          The x coordinates of the samples are in increasing order.
+
+          Before the samples are mapped the interval of samples, that
+          is inside the visible area of the canvas, is found by
+          binary search ( see qwtUpperSampleIndex() ). One sample
+          left and right of the visible area is included, so that
+          lines are still entering/leaving the canvas correctly.
+
+          For curves, where only a small part of the samples is
+          visible ( f.e. after zooming into a long time series ), the
+          cost for painting becomes proportional to the number of
+          visible samples.
+
+          \note Enabling MonotonicX for series, that are not sorted,
+                results in missing parts of the curve.
+         */
+        MonotonicX = 0x20,
+
+        /*!
+          Keep the curve rendered to an image, that is reused as long
+          as the scale maps and the canvas rectangle do not change.
+          When samples have been appended to the series only the new
+          samples are rendered into the image.
+
+          In combination with MonotonicX the image is also scrolled, when
+          the x axis has been shifted ( f.e. by a scrolling time axis ),
+          so that only the newly exposed area has to be rendered.
+
+          The cache is used only, when the curve is painted to
+          a raster device, without a brush and without curve fitting.
+
+          \note The cache assumes, that the samples, that have already
+                been painted, do not change. Otherwise invalidateCache()
+                has to be called.
+
+          \sa invalidateCache()
+         */
+        AppendCache = 0x40
     };
 
     //! Paint attributes
@@ -245,6 +292,11 @@ public:
     void setPaintAttribute( PaintAttribute, bool on = true );
     bool testPaintAttribute( PaintAttribute ) const;
 
+    void invalidateCache();
+
+    void setPointIndexEnabled( bool on );
+    bool isPointIndexEnabled() const;
+
     void setLegendAttribute( LegendAttribute, bool on = true );
     bool testLegendAttribute( LegendAttribute ) const;
 
@@ -274,6 +326,9 @@ public:
 
     virtual int closestPoint( const QPoint &pos, double *dist = NULL ) const;
 
+    QVector<int> closestPoints( const QPolygon &positions,
+        QVector<double> *distances = NULL ) const;
+
     double minXValue() const;
     double maxXValue() const;
     double minYValue() const;
@@ -311,6 +366,8 @@ protected:
 
     void init();
 
+    virtual void dataChanged() QWT_OVERRIDE;
+
     virtual void drawCurve( QPainter *, int style,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
@@ -343,6 +400,13 @@ protected:
         const QwtScaleMap &, const QwtScaleMap &, QPolygonF & ) const;
 
 private:
+    bool drawCached( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect ) const;
+
+    int findClosestPoint( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QPointF &pos, double *dist ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
@@ -51,6 +51,7 @@ QwtPlotGrid::QwtPlotGrid():
     d_data = new PrivateData;
 
     setItemInterest( QwtPlotItem::ScaleInterest, true );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
     setZ( 10.0 );
 }
 
@@ -91,6 +91,7 @@ void QwtPlotHistogram::init()
 
     setItemAttribute( QwtPlotItem::AutoScale, true );
     setItemAttribute( QwtPlotItem::Legend, true );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     setZ( 20.0 );
 }
@@ -209,6 +210,8 @@ void QwtPlotHistogram::setSymbol( const QwtColumnSymbol *symbol )
 {
     if ( symbol != d_data->symbol )
     {
+        waitForFrame();
+
         delete d_data->symbol;
         d_data->symbol = symbol;
 
@@ -14,6 +14,9 @@
 #include "qwt_painter.h"
 #include "qwt_graphic.h"
 #include "qwt_text.h"
+#include "qwt_math.h"
+#include "qwt_point_index.h"
+#include "qwt_plot.h"
 
 #include <qpainter.h>
 #include <cstring>
@@ -44,6 +47,18 @@ static inline bool qwtIsVSampleInside( const QwtIntervalSample &sample,
     return !isOffScreen;
 }
 
+static inline QPointF qwtCenter(
+    const QwtIntervalSample &sample, bool isVertical )
+{
+    const double center = 0.5 * ( sample.interval.minValue()
+        + sample.interval.maxValue() );
+
+    if ( isVertical )
+        return QPointF( sample.value, center );
+
+    return QPointF( center, sample.value );
+}
+
 class QwtPlotIntervalCurve::PrivateData
 {
 public:
@@ -51,7 +66,9 @@ public:
         style( QwtPlotIntervalCurve::Tube ),
         symbol( NULL ),
         pen( Qt::black ),
-        brush( Qt::white )
+        brush( Qt::white ),
+        pointIndex( NULL ),
+        indexOrientation( Qt::Vertical )
     {
         paintAttributes = QwtPlotIntervalCurve::ClipPolygons;
         paintAttributes |= QwtPlotIntervalCurve::ClipSymbol;
@@ -62,6 +79,7 @@ public:
     ~PrivateData()
     {
         delete symbol;
+        delete pointIndex;
     }
 
     QwtPlotIntervalCurve::CurveStyle style;
@@ -71,6 +89,10 @@ public:
     QBrush brush;
 
     QwtPlotIntervalCurve::PaintAttributes paintAttributes;
+
+    // positions of the centers of the intervals
+    QwtPointIndex *pointIndex;
+    Qt::Orientation indexOrientation;
 };
 
 /*!
@@ -104,6 +126,7 @@ void QwtPlotIntervalCurve::init()
 {
     setItemAttribute( QwtPlotItem::Legend, true );
     setItemAttribute( QwtPlotItem::AutoScale, true );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     d_data = new PrivateData;
     setData( new QwtIntervalSeriesData() );
@@ -205,6 +228,8 @@ void QwtPlotIntervalCurve::setSymbol( const QwtIntervalSymbol *symbol )
 {
     if ( symbol != d_data->symbol )
     {
+        waitForFrame();
+
         delete d_data->symbol;
         d_data->symbol = symbol;
 
@@ -306,6 +331,116 @@ QRectF QwtPlotIntervalCurve::boundingRect() const
     return rect;
 }
 
+/*!
+   \brief En/Disable a spatial index for closestPoint()
+
+   Without an index closestPoint() iterates over all samples.
+
+   The index is built with the next lookup and needs additional memory
+   for a copy of the centers of the intervals. Samples, that have been
+   appended later, are added incrementally.
+
+   \param on On/Off
+   \sa isPointIndexEnabled(), closestPoint(), QwtPointIndex
+*/
+void QwtPlotIntervalCurve::setPointIndexEnabled( bool on )
+{
+    if ( on == isPointIndexEnabled() )
+        return;
+
+    if ( on )
+    {
+        d_data->pointIndex = new QwtPointIndex();
+    }
+    else
+    {
+        delete d_data->pointIndex;
+        d_data->pointIndex = NULL;
+    }
+}
+
+/*!
+   \return True, when a spatial index is used for closestPoint()
+   \sa setPointIndexEnabled()
+*/
+bool QwtPlotIntervalCurve::isPointIndexEnabled() const
+{
+    return d_data->pointIndex != NULL;
+}
+
+/*!
+  Find the closest interval for a specific position
+
+  The distance is measured to the center of the intervals.
+
+  \param pos Position, where to look for the closest interval
+  \param dist If dist != NULL, closestPoint() returns the distance between
+              the position and the center of the closest interval
+  \return Index of the closest interval, or -1 if none can be found
+
+  \note Without a point index closestPoint() iterates over all samples
+  \sa setPointIndexEnabled()
+*/
+int QwtPlotIntervalCurve::closestPoint( const QPoint &pos, double *dist ) const
+{
+    const int numSamples = static_cast<int>( dataSize() );
+
+    if ( plot() == NULL || numSamples <= 0 )
+        return -1;
+
+    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
+    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
+
+    const bool isVertical = ( orientation() == Qt::Vertical );
+
+    QwtPointIndex *pointIndex = d_data->pointIndex;
+    if ( pointIndex == NULL )
+    {
+        int index = -1;
+        double dmin = 1.0e10;
+
+        for ( int i = 0; i < numSamples; i++ )
+        {
+            const QPointF p = qwtCenter( sample( i ), isVertical );
+
+            const double cx = xMap.transform( p.x() ) - pos.x();
+            const double cy = yMap.transform( p.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
+        }
+
+        if ( dist )
+            *dist = std::sqrt( dmin );
+
+        return index;
+    }
+
+    if ( pointIndex->size() > numSamples
+        || d_data->indexOrientation != orientation() )
+    {
+        pointIndex->clear();
+        d_data->indexOrientation = orientation();
+    }
+
+    for ( int i = pointIndex->size(); i < numSamples; i++ )
+        pointIndex->append( qwtCenter( sample( i ), isVertical ) );
+
+    return pointIndex->closestPoint( xMap, yMap, pos, dist );
+}
+
+//! Invalidate the point index and update the plot
+void QwtPlotIntervalCurve::dataChanged()
+{
+    if ( d_data->pointIndex )
+        d_data->pointIndex->clear();
+    QwtPlotSeriesItem::dataChanged();
+}
+
 /*!
   Draw a subset of the samples
 
@@ -104,12 +104,17 @@ public:
     void setSymbol( const QwtIntervalSymbol * );
     const QwtIntervalSymbol *symbol() const;
 
+    void setPointIndexEnabled( bool on );
+    bool isPointIndexEnabled() const;
+
     virtual void drawSeries( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const QWT_OVERRIDE;
 
     virtual QRectF boundingRect() const QWT_OVERRIDE;
 
+    virtual int closestPoint( const QPoint &pos, double *dist = NULL ) const;
+
     virtual QwtGraphic legendIcon(
         int index, const QSizeF & ) const QWT_OVERRIDE;
 
@@ -117,6 +122,8 @@ protected:
 
     void init();
 
+    virtual void dataChanged() QWT_OVERRIDE;
+
     virtual void drawTube( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
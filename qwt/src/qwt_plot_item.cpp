@@ -10,12 +10,18 @@
 #include "qwt_plot_item.h"
 #include "qwt_text.h"
 #include "qwt_plot.h"
+#include "qwt_plot_canvas.h"
 #include "qwt_legend_data.h"
 #include "qwt_scale_map.h"
 #include "qwt_graphic.h"
 
 #include <qpainter.h>
 
+static inline QwtPlotCanvas *qwtCanvas( QwtPlot *plot )
+{
+    return plot ? qobject_cast<QwtPlotCanvas *>( plot->canvas() ) : NULL;
+}
+
 class QwtPlotItem::PrivateData
 {
 public:
@@ -27,6 +33,7 @@ public:
         renderHints( 0 ),
         renderThreadCount( 1 ),
         z( 0.0 ),
+        renderLayer( 0 ),
         xAxis( QwtPlot::xBottom ),
         yAxis( QwtPlot::yLeft ),
         legendIconSize( 8, 8 )
@@ -44,6 +51,7 @@ public:
     uint renderThreadCount;
 
     double z;
+    int renderLayer;
 
     int xAxis;
     int yAxis;
@@ -181,6 +189,47 @@ void QwtPlotItem::setZ( double z )
     }
 }
 
+/*!
+   \brief Assign the item to a layer of the canvas backing store
+
+   With QwtPlotCanvas::LayeredBackingStore each layer > 0 is cached in
+   an image of its own, so that changing the items of one layer
+   does not require to repaint the items of the other layers.
+   Layers are composed in increasing order on top of the layer 0 - regardless
+   of the z value of their items.
+
+   The default layer is 0.
+
+   \param layer Layer, values < 0 are treated like 0
+   \sa renderLayer(), QwtPlotCanvas::replotLayer()
+*/
+void QwtPlotItem::setRenderLayer( int layer )
+{
+    if ( d_data->renderLayer != layer )
+    {
+        QwtPlotCanvas *canvas = qwtCanvas( d_data->plot );
+        if ( canvas )
+        {
+            canvas->waitForFrame();
+
+            // the item has to be removed from the image of the previous layer
+            canvas->markLayerDirty( d_data->renderLayer );
+        }
+
+        d_data->renderLayer = layer;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Layer of the canvas backing store
+   \sa setRenderLayer()
+*/
+int QwtPlotItem::renderLayer() const
+{
+    return d_data->renderLayer;
+}
+
 /*!
    Set a new title
 
@@ -477,14 +526,46 @@ bool QwtPlotItem::isVisible() const
 
 /*!
    Update the legend and call QwtPlot::autoRefresh() for the
-   parent plot.
+   parent plot. The render layer of the item is marked as outdated.
+
+   With QwtPlotCanvas::AsyncRendering itemChanged() blocks until
+   the frame in progress has been finished.
 
-   \sa QwtPlot::legendChanged(), QwtPlot::autoRefresh()
+   \sa QwtPlot::legendChanged(), QwtPlot::autoRefresh(),
+       QwtPlotCanvas::markLayerDirty()
 */
 void QwtPlotItem::itemChanged()
 {
     if ( d_data->plot )
+    {
+        QwtPlotCanvas *canvas = qwtCanvas( d_data->plot );
+        if ( canvas )
+        {
+            // a frame, that is rendered in the background, might access the item
+            canvas->waitForFrame();
+
+            canvas->markLayerDirty( d_data->renderLayer );
+        }
+
         d_data->plot->autoRefresh();
+    }
+}
+
+/*!
+   \brief Wait for a frame, that is rendered in the background
+
+   With QwtPlotCanvas::AsyncRendering the items are painted in
+   a worker thread. Before anything, that is accessed by draw(), gets
+   deleted or replaced, the frame in progress has to be finished.
+   For all other modifications itemChanged() waits implicitly.
+
+   \sa QwtPlotCanvas::waitForFrame(), itemChanged()
+*/
+void QwtPlotItem::waitForFrame() const
+{
+    QwtPlotCanvas *canvas = qwtCanvas( d_data->plot );
+    if ( canvas )
+        canvas->waitForFrame();
 }
 
 /*!
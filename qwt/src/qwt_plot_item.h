@@ -160,7 +160,18 @@ public:
            its bounding rectangle.
            \sa getCanvasMarginHint()
          */
-        Margins = 0x04
+        Margins = 0x04,
+
+        /*!
+           The item is painted according to the scale maps only, so that
+           its image can be shifted, when the scales are panned.
+           Items painted at fixed canvas positions ( f.e. a legend or a
+           text label ) must not set this attribute. It is disabled
+           by default, also for items derived from QwtPlotSeriesItem.
+
+           \sa QwtPlotCanvas::scrollBackingStore()
+         */
+        Scrollable = 0x08
     };
 
     //! Plot Item Attributes
@@ -245,6 +256,9 @@ public:
     double z() const;
     void setZ( double z );
 
+    void setRenderLayer( int layer );
+    int renderLayer() const;
+
     void show();
     void hide();
     virtual void setVisible( bool );
@@ -295,6 +309,7 @@ public:
 
 protected:
     QwtGraphic defaultIcon( const QBrush &, const QSizeF & ) const;
+    void waitForFrame() const;
 
 private:
     Q_DISABLE_COPY(QwtPlotItem)
@@ -700,6 +700,9 @@ void QwtPlotLegendItem::updateLegend( const QwtPlotItem *plotItem,
     if ( plotItem == NULL )
         return;
 
+    // the layout is read, when a frame is rendered in the background
+    waitForFrame();
+
     QList<QwtLegendLayoutItem *> layoutItems;
 
     QMap<const QwtPlotItem *, QList<QwtLegendLayoutItem *> >::const_iterator it =
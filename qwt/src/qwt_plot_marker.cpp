@@ -392,6 +392,8 @@ void QwtPlotMarker::setSymbol( const QwtSymbol *symbol )
 {
     if ( symbol != d_data->symbol )
     {
+        waitForFrame();
+
         delete d_data->symbol;
         d_data->symbol = symbol;
 
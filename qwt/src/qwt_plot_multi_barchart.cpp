@@ -74,6 +74,8 @@ QwtPlotMultiBarChart::~QwtPlotMultiBarChart()
 
 void QwtPlotMultiBarChart::init()
 {
+    setItemAttribute( QwtPlotItem::Scrollable, true );
+
     d_data = new PrivateData;
     setData( new QwtSetSeriesData() );
 }
@@ -166,6 +168,9 @@ void QwtPlotMultiBarChart::setSymbol( int valueIndex, QwtColumnSymbol *symbol )
     if ( valueIndex < 0 )
         return;
 
+    // the symbol map is read, when a frame is rendered in the background
+    waitForFrame();
+
     QMap<int, QwtColumnSymbol *>::iterator it =
         d_data->symbolMap.find(valueIndex);
     if ( it == d_data->symbolMap.end() )
@@ -236,6 +241,8 @@ QwtColumnSymbol *QwtPlotMultiBarChart::symbol( int valueIndex )
  */
 void QwtPlotMultiBarChart::resetSymbolMap()
 {
+    waitForFrame();
+
     qDeleteAll( d_data->symbolMap );
     d_data->symbolMap.clear();
 }
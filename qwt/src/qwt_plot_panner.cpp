@@ -10,9 +10,11 @@
 #include "qwt_plot_panner.h"
 #include "qwt_scale_div.h"
 #include "qwt_plot.h"
+#include "qwt_plot_canvas.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
 
+#include <qapplication.h>
 #include <qbitmap.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
@@ -208,10 +210,17 @@ const QwtPlot *QwtPlotPanner::plot() const
 /*!
    Adjust the enabled axes according to dx/dy
 
+   With tracking enabled moveCanvas() is called for each mouse move.
+   Then the canvas tries to shift its backing store and to render
+   the exposed strips only. When this is not possible - f.e. because
+   of an item without the QwtPlotItem::Scrollable attribute -
+   the plot is replotted completely.
+
    \param dx Pixel offset in x direction
    \param dy Pixel offset in y direction
 
-   \sa QwtPanner::panned()
+   \sa QwtPanner::panned(), QwtPanner::setTracking(),
+       QwtPlotCanvas::scrollBackingStore()
 */
 void QwtPlotPanner::moveCanvas( int dx, int dy )
 {
@@ -251,6 +260,27 @@ void QwtPlotPanner::moveCanvas( int dx, int dy )
     }
 
     plot->setAutoReplot( doAutoReplot );
+
+    const QwtPlotCanvas *plotCanvas =
+        qobject_cast< const QwtPlotCanvas *>( canvas() );
+
+    // while a frame is rendered in the background replot() defers the update
+    if ( hasTracking() && !( plotCanvas && plotCanvas->isRenderingFrame() ) )
+    {
+        plot->updateAxes();
+
+        // process changes of the layout, before shifting the canvas
+        QApplication::sendPostedEvents( plot, QEvent::LayoutRequest );
+
+        bool ok = false;
+        ( void )QMetaObject::invokeMethod( canvas(), "scrollBackingStore",
+            Qt::DirectConnection, Q_RETURN_ARG( bool, ok ),
+            Q_ARG( int, dx ), Q_ARG( int, dy ) );
+
+        if ( ok )
+            return;
+    }
+
     plot->replot();
 }
 
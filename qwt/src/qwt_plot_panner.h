@@ -25,7 +25,9 @@ class QwtPlot;
   Together with QwtPlotZoomer and QwtPlotMagnifier powerful ways
   of navigating on a QwtPlot widget can be implemented easily.
 
-  \note The axes are not updated, while dragging the canvas
+  \note The axes are not updated, while dragging the canvas - unless
+        tracking is enabled. Then the canvas follows the mouse by
+        shifting its backing store and rendering the exposed areas only.
   \sa QwtPlotZoomer, QwtPlotMagnifier
 */
 class QWT_EXPORT QwtPlotPanner: public QwtPanner
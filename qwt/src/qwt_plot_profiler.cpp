@@ -0,0 +1,367 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_profiler.h"
+
+#include <qvector.h>
+#include <qhash.h>
+#include <qmutex.h>
+
+namespace
+{
+    class Window
+    {
+    public:
+        Window():
+            next( 0 ),
+            numSamples( 0 ),
+            numPoints( 0 )
+        {
+        }
+
+        void append( int windowSize, double value )
+        {
+            if ( values.size() < windowSize )
+            {
+                values += value;
+                next = values.size() % windowSize;
+            }
+            else
+            {
+                values[next] = value;
+                next = ( next + 1 ) % windowSize;
+            }
+        }
+
+        void resize( int windowSize )
+        {
+            if ( values.size() > windowSize )
+            {
+                // keep the most recent values in chronological order
+
+                QVector<double> v( windowSize );
+                for ( int i = 0; i < windowSize; i++ )
+                {
+                    const int index = next - windowSize + i;
+                    v[i] = values[ ( index + values.size() ) % values.size() ];
+                }
+
+                values = v;
+                next = 0;
+            }
+            else if ( next != 0 )
+            {
+                // the buffer has to be unrolled before it can grow
+
+                QVector<double> v;
+                v.reserve( windowSize );
+
+                for ( int i = next; i < values.size(); i++ )
+                    v += values[i];
+
+                for ( int i = 0; i < next; i++ )
+                    v += values[i];
+
+                values = v;
+                next = values.size() % windowSize;
+            }
+        }
+
+        QwtPlotProfileCollector::Statistics statistics() const
+        {
+            QwtPlotProfileCollector::Statistics s;
+            s.numSamples = numSamples;
+            s.numPoints = numPoints;
+
+            if ( values.isEmpty() )
+                return s;
+
+            double sum = 0.0;
+            for ( int i = 0; i < values.size(); i++ )
+            {
+                sum += values[i];
+                if ( values[i] > s.maximum )
+                    s.maximum = values[i];
+            }
+
+            s.count = values.size();
+            s.average = sum / values.size();
+
+            const int last = ( next > 0 ) ? next - 1 : values.size() - 1;
+            s.last = values[last];
+
+            return s;
+        }
+
+        QVector<double> values;
+        int next;
+
+        int numSamples;
+        int numPoints;
+    };
+}
+
+static inline double qwtMSecs( qint64 nsecs )
+{
+    return nsecs / 1e6;
+}
+
+//! Constructor
+QwtPlotProfiler::QwtPlotProfiler()
+{
+}
+
+//! Destructor
+QwtPlotProfiler::~QwtPlotProfiler()
+{
+}
+
+/*!
+  \brief Report the time spent in a phase of the replot pipeline
+
+  \param phase Phase, that has been finished
+  \param nsecs Elapsed time in nanoseconds
+ */
+void QwtPlotProfiler::phaseFinished( Phase phase, qint64 nsecs )
+{
+    Q_UNUSED( phase )
+    Q_UNUSED( nsecs )
+}
+
+/*!
+  \brief Report the time spent in QwtPlotItem::draw()
+
+  \param item Plot item
+  \param nsecs Elapsed time in nanoseconds
+ */
+void QwtPlotProfiler::itemDrawn( const QwtPlotItem *item, qint64 nsecs )
+{
+    Q_UNUSED( item )
+    Q_UNUSED( nsecs )
+}
+
+/*!
+  \brief Report the effect of weeding out points
+
+  \param item Plot item
+  \param numSamples Number of samples, that have been mapped
+  \param numPoints Number of points, that have been passed to the painter
+ */
+void QwtPlotProfiler::samplesMapped( const QwtPlotItem *item,
+    int numSamples, int numPoints )
+{
+    Q_UNUSED( item )
+    Q_UNUSED( numSamples )
+    Q_UNUSED( numPoints )
+}
+
+//! Initializes all values with 0
+QwtPlotProfileCollector::Statistics::Statistics():
+    count( 0 ),
+    last( 0.0 ),
+    average( 0.0 ),
+    maximum( 0.0 ),
+    numSamples( 0 ),
+    numPoints( 0 )
+{
+}
+
+class QwtPlotProfileCollector::PrivateData
+{
+public:
+    // the hooks might be called from a background thread
+    mutable QMutex mutex;
+
+    int windowSize;
+
+    Window phases[PhaseCount];
+    QHash<const QwtPlotItem *, Window> items;
+};
+
+/*!
+  \brief Constructor
+  \param windowSize Number of frames, that are taken into account
+ */
+QwtPlotProfileCollector::QwtPlotProfileCollector( int windowSize )
+{
+    d_data = new PrivateData;
+    d_data->windowSize = qMax( windowSize, 1 );
+}
+
+//! Destructor
+QwtPlotProfileCollector::~QwtPlotProfileCollector()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Set the number of frames, that are taken into account
+
+  Older values are dropped, when the window is reduced.
+
+  \param size Window size
+  \sa windowSize()
+ */
+void QwtPlotProfileCollector::setWindowSize( int size )
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    size = qMax( size, 1 );
+    if ( size == d_data->windowSize )
+        return;
+
+    d_data->windowSize = size;
+
+    for ( int i = 0; i < PhaseCount; i++ )
+        d_data->phases[i].resize( size );
+
+    for ( QHash<const QwtPlotItem *, Window>::iterator it = d_data->items.begin();
+        it != d_data->items.end(); ++it )
+    {
+        it.value().resize( size );
+    }
+}
+
+/*!
+  \return Number of frames, that are taken into account
+  \sa setWindowSize()
+ */
+int QwtPlotProfileCollector::windowSize() const
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    return d_data->windowSize;
+}
+
+//! Remove all collected values
+void QwtPlotProfileCollector::reset()
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    for ( int i = 0; i < PhaseCount; i++ )
+        d_data->phases[i] = Window();
+
+    d_data->items.clear();
+}
+
+/*!
+  \brief Remove the statistics of an item
+  \param item Plot item
+ */
+void QwtPlotProfileCollector::removeItem( const QwtPlotItem *item )
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    d_data->items.remove( item );
+}
+
+/*!
+  \param phase Phase of the replot pipeline
+  \return Statistics of a phase
+ */
+QwtPlotProfileCollector::Statistics
+QwtPlotProfileCollector::phaseStatistics( Phase phase ) const
+{
+    if ( phase < 0 || phase >= PhaseCount )
+        return Statistics();
+
+    QMutexLocker locker( &d_data->mutex );
+    return d_data->phases[phase].statistics();
+}
+
+/*!
+  \param item Plot item
+  \return Statistics of a plot item
+ */
+QwtPlotProfileCollector::Statistics
+QwtPlotProfileCollector::itemStatistics( const QwtPlotItem *item ) const
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    QHash<const QwtPlotItem *, Window>::const_iterator it =
+        d_data->items.constFind( item );
+
+    if ( it == d_data->items.constEnd() )
+        return Statistics();
+
+    return it.value().statistics();
+}
+
+//! \return Items, that have been reported
+QList<const QwtPlotItem *> QwtPlotProfileCollector::items() const
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    return d_data->items.keys();
+}
+
+/*!
+  \param msecs Time budget in ms
+  \return Items, where the maximum draw time in the window exceeds msecs
+ */
+QList<const QwtPlotItem *> QwtPlotProfileCollector::itemsAboveBudget(
+    double msecs ) const
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    QList<const QwtPlotItem *> items;
+
+    for ( QHash<const QwtPlotItem *, Window>::const_iterator it =
+        d_data->items.constBegin(); it != d_data->items.constEnd(); ++it )
+    {
+        if ( it.value().statistics().maximum > msecs )
+            items += it.key();
+    }
+
+    return items;
+}
+
+/*!
+  Append the time to the window of the phase
+
+  \param phase Phase, that has been finished
+  \param nsecs Elapsed time in nanoseconds
+ */
+void QwtPlotProfileCollector::phaseFinished( Phase phase, qint64 nsecs )
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    if ( phase >= 0 && phase < PhaseCount )
+        d_data->phases[phase].append( d_data->windowSize, qwtMSecs( nsecs ) );
+}
+
+/*!
+  Append the time to the window of the item
+
+  \param item Plot item
+  \param nsecs Elapsed time in nanoseconds
+ */
+void QwtPlotProfileCollector::itemDrawn( const QwtPlotItem *item, qint64 nsecs )
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    d_data->items[item].append( d_data->windowSize, qwtMSecs( nsecs ) );
+}
+
+/*!
+  Store the sample counts of the last draw operation of the item
+
+  \param item Plot item
+  \param numSamples Number of samples, that have been mapped
+  \param numPoints Number of points, that have been passed to the painter
+ */
+void QwtPlotProfileCollector::samplesMapped( const QwtPlotItem *item,
+    int numSamples, int numPoints )
+{
+    QMutexLocker locker( &d_data->mutex );
+
+    Window &window = d_data->items[item];
+    window.numSamples = numSamples;
+    window.numPoints = numPoints;
+}
@@ -0,0 +1,143 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PLOT_PROFILER_H
+#define QWT_PLOT_PROFILER_H
+
+#include "qwt_global.h"
+#include <qlist.h>
+
+class QwtPlotItem;
+
+/*!
+  \brief Interface for collecting timing information of the replot pipeline
+
+  A profiler can be assigned to a plot by QwtPlot::setProfiler(). Then
+  the plot, its canvas and the plot items report how much time was spent
+  in the different stages of painting a frame.
+
+  All hooks are called from the thread, where the plot is painted -
+  usually the GUI thread. With QwtPlotCanvas::AsyncRendering the hooks
+  of QwtPlot::drawItems() and the plot items are called from a
+  background thread, so implementations need to be thread-safe.
+  The default implementations do nothing.
+
+  \sa QwtPlotProfileCollector
+ */
+class QWT_EXPORT QwtPlotProfiler
+{
+public:
+    //! Stages of the replot pipeline
+    enum Phase
+    {
+        //! QwtPlot::updateAxes()
+        UpdateAxes,
+
+        //! QwtPlot::updateLayout()
+        UpdateLayout,
+
+        //! QwtPlot::drawItems(), including all items
+        DrawItems,
+
+        /*!
+          QwtPlot::drawItems() for a part of the canvas only, like the
+          strips, that are exposed when scrolling the backing store.
+          The items are not reported by itemDrawn() for these draws.
+         */
+        DrawItemsPartial,
+
+        //! Copying the backing store of the canvas to the screen
+        BackingStore,
+
+        //! The complete paint event of the canvas
+        CanvasPaint,
+
+        //! Number of phases
+        PhaseCount
+    };
+
+    QwtPlotProfiler();
+    virtual ~QwtPlotProfiler();
+
+    virtual void phaseFinished( Phase, qint64 nsecs );
+    virtual void itemDrawn( const QwtPlotItem *, qint64 nsecs );
+
+    virtual void samplesMapped( const QwtPlotItem *,
+        int numSamples, int numPoints );
+
+private:
+    Q_DISABLE_COPY(QwtPlotProfiler)
+};
+
+/*!
+  \brief A profiler, that keeps rolling statistics
+
+  For each phase and each plot item the values of the last windowSize()
+  frames are stored.
+
+  All methods are thread-safe.
+
+  \note Plot items are identified by their address only. When an item
+        is deleted its statistics should be removed by removeItem().
+ */
+class QWT_EXPORT QwtPlotProfileCollector: public QwtPlotProfiler
+{
+public:
+    //! Statistics of the values in the current window
+    class QWT_EXPORT Statistics
+    {
+    public:
+        Statistics();
+
+        //! Number of values in the window
+        int count;
+
+        //! Most recent value in ms
+        double last;
+
+        //! Average of the values in ms
+        double average;
+
+        //! Maximum of the values in ms
+        double maximum;
+
+        //! Number of samples, that have been mapped by the last draw
+        int numSamples;
+
+        //! Number of points, that have been drawn after weeding
+        int numPoints;
+    };
+
+    explicit QwtPlotProfileCollector( int windowSize = 60 );
+    virtual ~QwtPlotProfileCollector();
+
+    void setWindowSize( int );
+    int windowSize() const;
+
+    void reset();
+    void removeItem( const QwtPlotItem * );
+
+    Statistics phaseStatistics( Phase ) const;
+    Statistics itemStatistics( const QwtPlotItem * ) const;
+
+    QList<const QwtPlotItem *> items() const;
+    QList<const QwtPlotItem *> itemsAboveBudget( double msecs ) const;
+
+    virtual void phaseFinished( Phase, qint64 nsecs ) QWT_OVERRIDE;
+    virtual void itemDrawn( const QwtPlotItem *, qint64 nsecs ) QWT_OVERRIDE;
+
+    virtual void samplesMapped( const QwtPlotItem *,
+        int numSamples, int numPoints ) QWT_OVERRIDE;
+
+private:
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
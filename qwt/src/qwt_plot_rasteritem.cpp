@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "qwt_plot_rasteritem.h"
+#include "qwt_plot.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
 #include "qwt_text.h"
@@ -17,25 +18,69 @@
 #include <qpainter.h>
 #include <qpaintengine.h>
 #include <qthread.h>
-#include <qfuture.h>
-#include <qtconcurrentrun.h>
+#include <qthreadpool.h>
+#include <qrunnable.h>
+#include <qsemaphore.h>
+#include <qatomic.h>
+#include <qtimer.h>
+#include <qelapsedtimer.h>
 
 #include <limits>
 
+namespace
+{
+    // triggers a replot in full resolution, when the interaction stops
+    class RefinementTimer: public QTimer
+    {
+    public:
+        explicit RefinementTimer( const QwtPlotItem *item ):
+            d_item( item )
+        {
+            setSingleShot( true );
+        }
+
+    protected:
+        virtual void timerEvent( QTimerEvent *event ) QWT_OVERRIDE
+        {
+            QTimer::timerEvent( event );
+
+            // the item might have been attached to another plot meanwhile
+            QwtPlot *plot = d_item->plot();
+            if ( plot )
+                plot->replot();
+        }
+
+    private:
+        const QwtPlotItem *d_item;
+    };
+}
+
 class QwtPlotRasterItem::PrivateData
 {
 public:
     PrivateData():
         alpha( -1 ),
-        paintAttributes( QwtPlotRasterItem::PaintInDeviceResolution )
+        paintAttributes( QwtPlotRasterItem::PaintInDeviceResolution ),
+        threadPool( NULL )
     {
         cache.policy = QwtPlotRasterItem::NoCache;
+
+        progressive.factor = 4;
+        progressive.delay = 150;
+        progressive.timer = NULL;
+    }
+
+    ~PrivateData()
+    {
+        delete progressive.timer;
     }
 
     int alpha;
 
     QwtPlotRasterItem::PaintAttributes paintAttributes;
 
+    QThreadPool *threadPool;
+
     struct ImageCache
     {
         QwtPlotRasterItem::CachePolicy policy;
@@ -43,6 +88,21 @@ public:
         QSizeF size;
         QImage image;
     } cache;
+
+    struct ProgressiveData
+    {
+        int factor;
+        int delay;
+
+        // time since the last image has been rendered
+        QElapsedTimer lastRender;
+
+        // area and size of the last image
+        QRectF lastArea;
+        QSize lastSize;
+
+        QTimer *timer;
+    } progressive;
 };
 
 
@@ -358,30 +418,30 @@ static void qwtAdjustMaps( QwtScaleMap &xMap, QwtScaleMap &yMap,
     yMap.setScaleInterval(sy1, sy2);
 }
 
-static bool qwtUseCache( QwtPlotRasterItem::CachePolicy policy,
-    const QPainter *painter )
+static bool qwtIsScreenPainter( const QPainter *painter )
 {
-    bool doCache = false;
-
-    if ( policy == QwtPlotRasterItem::PaintCache )
+    switch ( painter->paintEngine()->type() )
     {
-        // Caching doesn't make sense, when the item is
-        // not painted to screen
-
-        switch ( painter->paintEngine()->type() )
-        {
-            case QPaintEngine::SVG:
-            case QPaintEngine::Pdf:
-            case QPaintEngine::PostScript:
-            case QPaintEngine::MacPrinter:
-            case QPaintEngine::Picture:
-                break;
-            default:;
-                doCache = true;
-        }
+        case QPaintEngine::SVG:
+        case QPaintEngine::Pdf:
+        case QPaintEngine::PostScript:
+        case QPaintEngine::MacPrinter:
+        case QPaintEngine::Picture:
+            return false;
+        default:;
     }
 
-    return doCache;
+    return true;
+}
+
+static bool qwtUseCache( QwtPlotRasterItem::CachePolicy policy,
+    const QPainter *painter )
+{
+    // Caching doesn't make sense, when the item is
+    // not painted to screen
+
+    return ( policy == QwtPlotRasterItem::PaintCache )
+        && qwtIsScreenPainter( painter );
 }
 
 static void qwtToRgba( const QImage* from, QImage* to,
@@ -426,6 +486,176 @@ static void qwtToRgba( const QImage* from, QImage* to,
     }
 }
 
+namespace
+{
+    class TileJob
+    {
+    public:
+        virtual ~TileJob()
+        {
+        }
+
+        virtual void renderTile( const QRect &tile ) const = 0;
+    };
+
+    class AlphaTileJob: public TileJob
+    {
+    public:
+        AlphaTileJob( const QImage *from, QImage *to, int alpha ):
+            d_from( from ),
+            d_to( to ),
+            d_alpha( alpha )
+        {
+        }
+
+        virtual void renderTile( const QRect &tile ) const QWT_OVERRIDE
+        {
+            qwtToRgba( d_from, d_to, tile, d_alpha );
+        }
+
+    private:
+        const QImage *d_from;
+        QImage *d_to;
+        const int d_alpha;
+    };
+
+    /*
+        The image is divided into small tiles, that are fetched
+        one by one from a shared counter. So threads, that
+        have finished their tiles early, simply continue with the
+        next one, instead of waiting for the slow ones.
+     */
+    class TileScheduler
+    {
+    public:
+        enum
+        {
+            TileSize = 64,
+
+            // below this number of pixels the thread overhead dominates
+            MinParallelPixels = 4 * TileSize * TileSize
+        };
+
+        TileScheduler( const TileJob &job, const QSize &size ):
+            d_job( job ),
+            d_size( size ),
+            d_next( 0 )
+        {
+            d_numColumns = ( size.width() + TileSize - 1 ) / TileSize;
+            d_tileCount = d_numColumns * ( ( size.height() + TileSize - 1 ) / TileSize );
+        }
+
+        inline int tileCount() const
+        {
+            return d_tileCount;
+        }
+
+        void process()
+        {
+            while ( true )
+            {
+                const int index = d_next.fetchAndAddRelaxed( 1 );
+                if ( index >= d_tileCount )
+                    break;
+
+                const int x = ( index % d_numColumns ) * TileSize;
+                const int y = ( index / d_numColumns ) * TileSize;
+
+                const QRect tile( x, y,
+                    qMin( int( TileSize ), d_size.width() - x ),
+                    qMin( int( TileSize ), d_size.height() - y ) );
+
+                d_job.renderTile( tile );
+            }
+        }
+
+        QSemaphore finished;
+
+    private:
+        const TileJob &d_job;
+        const QSize d_size;
+
+        int d_numColumns;
+        int d_tileCount;
+
+        QAtomicInt d_next;
+    };
+
+    class TileRunnable: public QRunnable
+    {
+    public:
+        TileRunnable( TileScheduler *scheduler ):
+            d_scheduler( scheduler )
+        {
+            setAutoDelete( false );
+        }
+
+        virtual void run() QWT_OVERRIDE
+        {
+            d_scheduler->process();
+            d_scheduler->finished.release();
+        }
+
+    private:
+        TileScheduler *d_scheduler;
+    };
+}
+
+static void qwtRenderTiles( const TileJob &job, const QSize &size,
+    uint numThreads, QThreadPool *pool )
+{
+    TileScheduler scheduler( job, size );
+
+#if !defined(QT_NO_QFUTURE)
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    int numWorkers = qMin( int( numThreads ), scheduler.tileCount() ) - 1;
+    if ( size.width() * size.height() < TileScheduler::MinParallelPixels )
+        numWorkers = 0;
+
+    QVector< TileRunnable * > runnables;
+    runnables.reserve( numWorkers );
+
+    for ( int i = 0; i < numWorkers; i++ )
+    {
+        TileRunnable *runnable = new TileRunnable( &scheduler );
+        runnables += runnable;
+
+        pool->start( runnable );
+    }
+
+    // the calling thread is working on the tiles too
+    scheduler.process();
+
+    int numRunning = runnables.size();
+
+#if QT_VERSION >= 0x050900
+    /*
+        All tiles are done. Runnables, that have not been started
+        yet, have nothing to do and can be removed from the queue.
+        This also avoids waiting for a busy pool.
+     */
+    for ( int i = 0; i < runnables.size(); i++ )
+    {
+        if ( pool->tryTake( runnables[i] ) )
+            numRunning--;
+    }
+#endif
+
+    scheduler.finished.acquire( numRunning );
+    qDeleteAll( runnables );
+#else
+    Q_UNUSED( numThreads )
+    Q_UNUSED( pool )
+
+    scheduler.process();
+#endif
+}
+
 //! Constructor
 QwtPlotRasterItem::QwtPlotRasterItem( const QString& title ):
     QwtPlotItem( QwtText( title ) )
@@ -452,6 +682,7 @@ void QwtPlotRasterItem::init()
 
     setItemAttribute( QwtPlotItem::AutoScale, true );
     setItemAttribute( QwtPlotItem::Legend, false );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     setZ( 8.0 );
 }
@@ -469,6 +700,24 @@ void QwtPlotRasterItem::setPaintAttribute( PaintAttribute attribute, bool on )
         d_data->paintAttributes |= attribute;
     else
         d_data->paintAttributes &= ~attribute;
+
+    if ( attribute == ProgressiveRendering )
+    {
+        if ( on && d_data->progressive.timer == NULL )
+        {
+            QTimer *timer = new RefinementTimer( this );
+            timer->setInterval( d_data->progressive.delay );
+#if QT_VERSION >= 0x050000
+            // a timer, that fires early, would result in another coarse image
+            timer->setTimerType( Qt::PreciseTimer );
+#endif
+
+            d_data->progressive.timer = timer;
+        }
+
+        if ( !on && d_data->progressive.timer )
+            d_data->progressive.timer->stop();
+    }
 }
 
 /*!
@@ -563,11 +812,93 @@ QwtPlotRasterItem::CachePolicy QwtPlotRasterItem::cachePolicy() const
 */
 void QwtPlotRasterItem::invalidateCache()
 {
+    waitForFrame();
+
     d_data->cache.image = QImage();
     d_data->cache.area = QRect();
     d_data->cache.size = QSize();
 }
 
+/*!
+   \brief Set the resolution of the coarse images
+
+   With ProgressiveRendering the images, that are rendered during an
+   interaction, have a resolution of 1 / factor of the final image
+   in each direction. The default factor is 4.
+
+   \param factor Reduction factor, values < 1 are ignored
+   \sa progressiveFactor(), ProgressiveRendering
+*/
+void QwtPlotRasterItem::setProgressiveFactor( int factor )
+{
+    d_data->progressive.factor = qMax( factor, 1 );
+}
+
+/*!
+   \return Reduction factor of the coarse images
+   \sa setProgressiveFactor()
+*/
+int QwtPlotRasterItem::progressiveFactor() const
+{
+    return d_data->progressive.factor;
+}
+
+/*!
+   \brief Set the delay for rendering the image in full resolution
+
+   With ProgressiveRendering images for a different area or size,
+   that are requested within msecs after the previous one, are rendered
+   in a coarse resolution.
+   When no other image has been requested for msecs, the plot
+   is replotted in full resolution. The default delay is 150 ms.
+
+   \param msecs Delay in milliseconds
+   \sa refinementDelay(), ProgressiveRendering
+*/
+void QwtPlotRasterItem::setRefinementDelay( int msecs )
+{
+    d_data->progressive.delay = qMax( msecs, 0 );
+
+    if ( d_data->progressive.timer )
+        d_data->progressive.timer->setInterval( d_data->progressive.delay );
+}
+
+/*!
+   \return Delay for rendering the image in full resolution
+   \sa setRefinementDelay()
+*/
+int QwtPlotRasterItem::refinementDelay() const
+{
+    return d_data->progressive.delay;
+}
+
+/*!
+   \brief Assign a thread pool for rendering the image
+
+   The tiles of an image are rendered in parallel by the threads
+   of the pool. When no pool has been assigned, QThreadPool::globalInstance()
+   is used. The ownership of the pool is not transferred.
+
+   \param pool Thread pool
+   \sa threadPool(), renderTiles(), QwtPlotItem::setRenderThreadCount()
+*/
+void QwtPlotRasterItem::setThreadPool( QThreadPool *pool )
+{
+    d_data->threadPool = pool;
+}
+
+/*!
+   \return Thread pool for rendering the image
+   \sa setThreadPool()
+*/
+QThreadPool *QwtPlotRasterItem::threadPool() const
+{
+    if ( d_data->threadPool )
+        return d_data->threadPool;
+
+    return QThreadPool::globalInstance();
+}
+
 /*!
    \brief Pixel hint
 
@@ -614,7 +945,10 @@ void QwtPlotRasterItem::draw( QPainter *painter,
     if ( canvasRect.isEmpty() || d_data->alpha == 0 )
         return;
 
-    const bool doCache = qwtUseCache( d_data->cache.policy, painter );
+    bool doCache = qwtUseCache( d_data->cache.policy, painter );
+
+    const bool doProgressive = testPaintAttribute( ProgressiveRendering )
+        && d_data->progressive.timer && qwtIsScreenPainter( painter );
 
     const QwtInterval xInterval = interval( Qt::XAxis );
     const QwtInterval yInterval = interval( Qt::YAxis );
@@ -628,7 +962,27 @@ void QwtPlotRasterItem::draw( QPainter *painter,
     QwtScaleMap xxMap, yyMap;
     qwtTransformMaps( painter->transform(), xMap, yMap, xxMap, yyMap );
 
-    QRectF paintRect = painter->transform().mapRect( canvasRect );
+    // only the part inside the clip region has to be rendered
+    QRectF paintRect = canvasRect;
+    if ( painter->hasClipping() )
+    {
+#if QT_VERSION >= 0x040800
+        const QRectF clipRect = painter->clipBoundingRect();
+#else
+        const QRectF clipRect = painter->clipRegion().boundingRect();
+#endif
+        if ( !clipRect.contains( canvasRect ) )
+        {
+            paintRect &= clipRect;
+            if ( paintRect.isEmpty() )
+                return;
+
+            // the cache is for images of the complete canvas only
+            doCache = false;
+        }
+    }
+
+    paintRect = painter->transform().mapRect( paintRect );
     QRectF area = QwtScaleMap::invTransform( xxMap, yyMap, paintRect );
 
     const QRectF br = boundingRect();
@@ -690,7 +1044,7 @@ void QwtPlotRasterItem::draw( QPainter *painter,
         // data pixels we render in resolution of the paint device.
 
         image = compose(xxMap, yyMap,
-            area, paintRect, paintRect.size().toSize(), doCache);
+            area, paintRect, paintRect.size().toSize(), doCache, doProgressive);
         if ( image.isNull() )
             return;
 
@@ -735,7 +1089,7 @@ void QwtPlotRasterItem::draw( QPainter *painter,
         imageSize.setHeight( qRound( imageArea.height() / pixelRect.height() ) );
 
         image = compose(xxMap, yyMap,
-            imageArea, paintRect, imageSize, doCache );
+            imageArea, paintRect, imageSize, doCache, doProgressive );
 
         if ( image.isNull() )
             return;
@@ -823,7 +1177,7 @@ QRectF QwtPlotRasterItem::boundingRect() const
 QImage QwtPlotRasterItem::compose(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QRectF &imageArea, const QRectF &paintRect,
-    const QSize &imageSize, bool doCache) const
+    const QSize &imageSize, bool doCache, bool doProgressive ) const
 {
     QImage image;
     if ( imageArea.isEmpty() || paintRect.isEmpty() || imageSize.isEmpty() )
@@ -841,23 +1195,61 @@ QImage QwtPlotRasterItem::compose(
 
     if ( image.isNull() )
     {
+        QSize renderSize = imageSize;
+
+        if ( doProgressive )
+        {
+            PrivateData::ProgressiveData &progressive = d_data->progressive;
+
+            /*
+                Images for different areas or sizes, requested in short
+                intervals, indicate an interaction. Images for the same area
+                are not, like when new data is streamed in.
+             */
+            const bool isInteractive = progressive.lastRender.isValid()
+                && progressive.lastRender.elapsed() < progressive.delay
+                && ( imageArea != progressive.lastArea
+                    || imageSize != progressive.lastSize );
+
+            progressive.lastRender.start();
+            progressive.lastArea = imageArea;
+            progressive.lastSize = imageSize;
+
+            if ( isInteractive && progressive.factor > 1 )
+            {
+                renderSize.setWidth(
+                    qMax( imageSize.width() / progressive.factor, 1 ) );
+                renderSize.setHeight(
+                    qMax( imageSize.height() / progressive.factor, 1 ) );
+
+                // (re)start the timer from the thread, where it lives
+                QMetaObject::invokeMethod( progressive.timer, "start" );
+            }
+        }
+
         double dx = 0.0;
-        if ( paintRect.toRect().width() > imageSize.width() )
-            dx = imageArea.width() / imageSize.width();
+        if ( paintRect.toRect().width() > renderSize.width() )
+            dx = imageArea.width() / renderSize.width();
 
         const QwtScaleMap xxMap =
-            imageMap(Qt::Horizontal, xMap, imageArea, imageSize, dx);
+            imageMap(Qt::Horizontal, xMap, imageArea, renderSize, dx);
 
         double dy = 0.0;
-        if ( paintRect.toRect().height() > imageSize.height() )
-            dy = imageArea.height() / imageSize.height();
+        if ( paintRect.toRect().height() > renderSize.height() )
+            dy = imageArea.height() / renderSize.height();
 
         const QwtScaleMap yyMap =
-            imageMap(Qt::Vertical, yMap, imageArea, imageSize, dy);
+            imageMap(Qt::Vertical, yMap, imageArea, renderSize, dy);
 
-        image = renderImage( xxMap, yyMap, imageArea, imageSize );
+        image = renderImage( xxMap, yyMap, imageArea, renderSize );
 
-        if ( doCache )
+        if ( renderSize != imageSize )
+        {
+            // the coarse image is neither cached, nor the paint cache invalidated
+            image = image.scaled( imageSize,
+                Qt::IgnoreAspectRatio, Qt::FastTransformation );
+        }
+        else if ( doCache )
         {
             d_data->cache.area = imageArea;
             d_data->cache.size = paintRect.size();
@@ -869,40 +1261,9 @@ QImage QwtPlotRasterItem::compose(
     {
         QImage alphaImage( image.size(), QImage::Format_ARGB32 );
 
-#if !defined(QT_NO_QFUTURE)
-        uint numThreads = renderThreadCount();
+        const AlphaTileJob job( &image, &alphaImage, d_data->alpha );
+        qwtRenderTiles( job, image.size(), renderThreadCount(), threadPool() );
 
-        if ( numThreads <= 0 )
-            numThreads = QThread::idealThreadCount();
-
-        if ( numThreads <= 0 )
-            numThreads = 1;
-
-        const int numRows = image.height() / numThreads;
-
-        QVector< QFuture<void> > futures;
-        futures.reserve( numThreads - 1 );
-
-        for ( uint i = 0; i < numThreads; i++ )
-        {
-            QRect tile( 0, i * numRows, image.width(), numRows );
-            if ( i == numThreads - 1 )
-            {
-                tile.setHeight( image.height() - i * numRows );
-                qwtToRgba( &image, &alphaImage, tile, d_data->alpha );
-            }
-            else
-            {
-                futures += QtConcurrent::run(
-                    &qwtToRgba, &image, &alphaImage, tile, d_data->alpha );
-            }
-        }
-        for ( int i = 0; i < futures.size(); i++ )
-            futures[i].waitForFinished();
-#else
-        const QRect tile( 0, 0, image.width(), image.height() );
-        qwtToRgba( &image, &alphaImage, tile, d_data->alpha );
-#endif
         image = alphaImage;
     }
 
@@ -965,3 +1326,78 @@ QwtScaleMap QwtPlotRasterItem::imageMap(
 
     return newMap;
 }
+
+/*!
+   \brief Render an image tile by tile
+
+   The image is divided into tiles of 64x64 pixels, that are passed
+   to renderTile(). The tiles are distributed dynamically to the
+   threads of threadPool(), so that threads finishing early continue with
+   the remaining tiles. At most renderThreadCount() threads ( including
+   the calling one ) are involved. Small images are rendered
+   in the calling thread only.
+
+   renderTiles() is intended to be called from an implementation
+   of renderImage().
+
+   \param xMap X-Scale Map
+   \param yMap Y-Scale Map
+   \param image Image to be rendered
+
+   \sa renderTile(), setThreadPool()
+*/
+void QwtPlotRasterItem::renderTiles(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap, QImage *image ) const
+{
+    class ImageTileJob: public TileJob
+    {
+    public:
+        ImageTileJob( const QwtPlotRasterItem *item,
+                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                QImage *image ):
+            d_item( item ),
+            d_xMap( xMap ),
+            d_yMap( yMap ),
+            d_image( image )
+        {
+        }
+
+        virtual void renderTile( const QRect &tile ) const QWT_OVERRIDE
+        {
+            d_item->renderTile( d_xMap, d_yMap, tile, d_image );
+        }
+
+    private:
+        const QwtPlotRasterItem *d_item;
+        const QwtScaleMap &d_xMap;
+        const QwtScaleMap &d_yMap;
+        QImage *d_image;
+    };
+
+    const ImageTileJob job( this, xMap, yMap, image );
+    qwtRenderTiles( job, image->size(), renderThreadCount(), threadPool() );
+}
+
+/*!
+   \brief Render a tile of an image
+
+   renderTile() is called from renderTiles() - usually from
+   different threads at the same time. The default implementation
+   does nothing.
+
+   \param xMap X-Scale Map
+   \param yMap Y-Scale Map
+   \param tile Geometry of the tile in image coordinates
+   \param image Image to be rendered
+
+   \sa renderTiles()
+*/
+void QwtPlotRasterItem::renderTile(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRect &tile, QImage *image ) const
+{
+    Q_UNUSED( xMap )
+    Q_UNUSED( yMap )
+    Q_UNUSED( tile )
+    Q_UNUSED( image )
+}
@@ -16,6 +16,7 @@
 #include <qstring.h>
 
 class QwtInterval;
+class QThreadPool;
 
 /*!
   \brief A class, which displays raster data
@@ -55,6 +56,9 @@ public:
           This type of cache is useful for improving the performance
           of hide/show operations or manipulations of the alpha value.
           All other situations are handled by the canvas backing store.
+
+          QwtPlotSpectrogram also caches its contour lines, so that
+          they don't need to be recalculated when panning.
          */
         PaintCache
     };
@@ -77,7 +81,20 @@ public:
           depends on the implementation of the specific QPaintEngine.
          */
 
-        PaintInDeviceResolution = 1
+        PaintInDeviceResolution = 1,
+
+        /*!
+          While the plot is navigated ( f.e. by QwtPlotMagnifier or
+          QwtPlotZoomer ) images are rendered in a coarse resolution
+          and scaled up. When the interaction stops the plot is
+          replotted in full resolution.
+
+          Images in full resolution are reused from the PaintCache,
+          when the maps return to the cached state.
+
+          \sa setProgressiveFactor(), setRefinementDelay()
+         */
+        ProgressiveRendering = 2
     };
 
     //! Paint attributes
@@ -96,7 +113,16 @@ public:
     void setCachePolicy( CachePolicy );
     CachePolicy cachePolicy() const;
 
-    void invalidateCache();
+    virtual void invalidateCache();
+
+    void setProgressiveFactor( int );
+    int progressiveFactor() const;
+
+    void setRefinementDelay( int msecs );
+    int refinementDelay() const;
+
+    void setThreadPool( QThreadPool * );
+    QThreadPool *threadPool() const;
 
     virtual void draw( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -132,6 +158,12 @@ protected:
         const QwtScaleMap &map, const QRectF &area,
         const QSize &imageSize, double pixelSize) const;
 
+    void renderTiles( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, QImage * ) const;
+
+    virtual void renderTile( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QRect &tile, QImage * ) const;
+
 private:
     explicit QwtPlotRasterItem( const QwtPlotRasterItem & );
     QwtPlotRasterItem &operator=( const QwtPlotRasterItem & );
@@ -140,7 +172,7 @@ private:
 
     QImage compose( const QwtScaleMap &, const QwtScaleMap &,
         const QRectF &imageArea, const QRectF &paintRect,
-        const QSize &imageSize, bool doCache) const;
+        const QSize &imageSize, bool doCache, bool doProgressive ) const;
 
 
     class PrivateData;
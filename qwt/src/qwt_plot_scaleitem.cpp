@@ -215,6 +215,8 @@ void QwtPlotScaleItem::setScaleDraw( QwtScaleDraw *scaleDraw )
         return;
 
     if ( scaleDraw != d_data->scaleDraw )
+        waitForFrame();
+
         delete d_data->scaleDraw;
 
     d_data->scaleDraw = scaleDraw;
@@ -109,6 +109,17 @@ void QwtPlotSeriesItem::updateScaleDiv(
     setRectOfInterest( rect );
 }
 
+/*!
+   Wait for a frame, that is rendered in the background, before
+   the series gets replaced
+
+   \sa QwtPlotItem::waitForFrame()
+ */
+void QwtPlotSeriesItem::dataAboutToChange()
+{
+    waitForFrame();
+}
+
 void QwtPlotSeriesItem::dataChanged()
 {
     itemChanged();
@@ -58,6 +58,7 @@ public:
         const QwtScaleDiv &, const QwtScaleDiv & ) QWT_OVERRIDE;
 
 protected:
+    virtual void dataAboutToChange() QWT_OVERRIDE;
     virtual void dataChanged() QWT_OVERRIDE;
 
 private:
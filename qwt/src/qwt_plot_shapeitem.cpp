@@ -143,6 +143,7 @@ void QwtPlotShapeItem::init()
 
     setItemAttribute( QwtPlotItem::AutoScale, true );
     setItemAttribute( QwtPlotItem::Legend, false );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     setZ( 8.0 );
 }
@@ -71,6 +71,7 @@ void QwtPlotSpectroCurve::init()
 {
     setItemAttribute( QwtPlotItem::Legend );
     setItemAttribute( QwtPlotItem::AutoScale );
+    setItemAttribute( QwtPlotItem::Scrollable );
 
     d_data = new PrivateData;
     setData( new QwtPoint3DSeriesData() );
@@ -148,6 +149,8 @@ void QwtPlotSpectroCurve::setColorMap( QwtColorMap *colorMap )
 {
     if ( colorMap != d_data->colorMap )
     {
+        waitForFrame();
+
         delete d_data->colorMap;
         d_data->colorMap = colorMap;
     }
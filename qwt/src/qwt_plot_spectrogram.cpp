@@ -17,9 +17,7 @@
 #include <qimage.h>
 #include <qpen.h>
 #include <qpainter.h>
-#include <qthread.h>
-#include <qfuture.h>
-#include <qtconcurrentrun.h>
+#include <qvector.h>
 
 #define DEBUG_RENDER 0
 
@@ -57,6 +55,8 @@ public:
 #if 0
         conrecFlags |= QwtRasterData::IgnoreOutOfRange;
 #endif
+
+        contourCache.reset();
     }
     ~PrivateData()
     {
@@ -89,6 +89,45 @@ public:
 
     int maxRGBColorTableSize;
     QVector<QRgb> colorTable;
+
+    class ContourCache
+    {
+    public:
+        bool isValid( const QRectF &rect, const QSize &raster ) const
+        {
+            if ( !area.isValid() || !area.contains( rect ) )
+                return false;
+
+            /*
+                The lines need to have been calculated for the same
+                resolution, but we ignore small deviations resulting
+                from rounding the raster size.
+             */
+            return isSimilar( rect.width() / raster.width(), dx )
+                && isSimilar( rect.height() / raster.height(), dy );
+        }
+
+        void reset()
+        {
+            area = QRectF();
+            dx = dy = 0.0;
+            lines.clear();
+            polylines.clear();
+        }
+
+        QRectF area;
+        double dx;
+        double dy;
+
+        QwtRasterData::ContourLines lines;
+        QwtRasterData::ContourPolylines polylines;
+
+    private:
+        static inline bool isSimilar( double d1, double d2 )
+        {
+            return qAbs( d1 - d2 ) <= 0.01 * qAbs( d2 );
+        }
+    } contourCache;
 };
 
 /*!
@@ -178,6 +217,8 @@ void QwtPlotSpectrogram::setColorMap( QwtColorMap *colorMap )
 
     if ( colorMap != d_data->colorMap )
     {
+        waitForFrame();
+
         delete d_data->colorMap;
         d_data->colorMap = colorMap;
     }
@@ -307,6 +348,8 @@ void QwtPlotSpectrogram::setConrecFlag(
     else
         d_data->conrecFlags &= ~flag;
 
+    d_data->contourCache.reset();
+
     itemChanged();
 }
 
@@ -342,6 +385,8 @@ void QwtPlotSpectrogram::setContourLevels( const QList<double> &levels )
     d_data->contourLevels = levels;
     qSort( d_data->contourLevels );
 
+    d_data->contourCache.reset();
+
     legendChanged();
     itemChanged();
 }
@@ -359,6 +404,21 @@ QList<double> QwtPlotSpectrogram::contourLevels() const
     return d_data->contourLevels;
 }
 
+/*!
+   \brief Invalidate the paint cache
+
+   Besides the cached image the cached contour lines are dropped.
+
+   \sa QwtPlotRasterItem::setCachePolicy()
+*/
+void QwtPlotSpectrogram::invalidateCache()
+{
+    waitForFrame();
+
+    d_data->contourCache.reset();
+    QwtPlotRasterItem::invalidateCache();
+}
+
 /*!
   Set the data to be displayed
 
@@ -369,6 +429,8 @@ void QwtPlotSpectrogram::setData( QwtRasterData *data )
 {
     if ( data != d_data->data )
     {
+        waitForFrame();
+
         delete d_data->data;
         d_data->data = data;
 
@@ -481,42 +543,7 @@ QImage QwtPlotSpectrogram::renderImage(
     time.start();
 #endif
 
-#if !defined(QT_NO_QFUTURE)
-    uint numThreads = renderThreadCount();
-
-    if ( numThreads <= 0 )
-        numThreads = QThread::idealThreadCount();
-
-    if ( numThreads <= 0 )
-        numThreads = 1;
-
-    const int numRows = imageSize.height() / numThreads;
-
-    QVector< QFuture<void> > futures;
-    futures.reserve( numThreads - 1 );
-
-    for ( uint i = 0; i < numThreads; i++ )
-    {
-        QRect tile( 0, i * numRows, image.width(), numRows );
-        if ( i == numThreads - 1 )
-        {
-            tile.setHeight( image.height() - i * numRows );
-            renderTile( xMap, yMap, tile, &image );
-        }
-        else
-        {
-            futures += QtConcurrent::run(
-                this, &QwtPlotSpectrogram::renderTile,
-                xMap, yMap, tile, &image );
-        }
-    }
-    for ( int i = 0; i < futures.size(); i++ )
-        futures[i].waitForFinished();
-
-#else
-    const QRect tile( 0, 0, image.width(), image.height() );
-    renderTile( xMap, yMap, tile, &image );
-#endif
+    renderTiles( xMap, yMap, &image );
 
 #if DEBUG_RENDER
     const qint64 elapsed = time.elapsed();
@@ -531,8 +558,8 @@ QImage QwtPlotSpectrogram::renderImage(
 /*!
     \brief Render a tile of an image.
 
-    Rendering in tiles can be used to composite an image in parallel
-    threads.
+    renderTile() is called from renderTiles(), that distributes
+    the tiles to the threads of the thread pool.
 
     \param xMap X-Scale Map
     \param yMap Y-Scale Map
@@ -549,66 +576,73 @@ void QwtPlotSpectrogram::renderTile(
 
     const bool hasGaps = !d_data->data->testAttribute( QwtRasterData::WithoutGaps );
 
-    if ( d_data->colorMap->format() == QwtColorMap::RGB )
+    // the x coordinates are the same for all rows of the tile
+
+    const int numColumns = tile.width();
+
+    QVector<double> xValues( numColumns );
+    QVector<double> values( numColumns );
+
+    for ( int i = 0; i < numColumns; i++ )
+        xValues[i] = xMap.invTransform( tile.left() + i );
+
+    QVector<uint> indexes( numColumns );
+
+    const double *tx = xValues.constData();
+    double *rowValues = values.data();
+    uint *rowIndexes = indexes.data();
+
+    const QwtColorMap *colorMap = d_data->colorMap;
+
+    if ( colorMap->format() == QwtColorMap::RGB )
     {
         const int numColors = d_data->colorTable.size();
         const QRgb *rgbTable = d_data->colorTable.constData();
-        const QwtColorMap *colorMap = d_data->colorMap;
 
         for ( int y = tile.top(); y <= tile.bottom(); y++ )
         {
             const double ty = yMap.invTransform( y );
+            d_data->data->valueRow( ty, tx, rowValues, numColumns );
 
             QRgb *line = reinterpret_cast<QRgb *>( image->scanLine( y ) );
             line += tile.left();
 
-            for ( int x = tile.left(); x <= tile.right(); x++ )
+            if ( numColors == 0 )
             {
-                const double tx = xMap.invTransform( x );
-
-                const double value = d_data->data->value( tx, ty );
+                // NaN values are mapped to 0u by rgbRow()
+                colorMap->rgbRow( range, rowValues, line, numColumns );
+            }
+            else
+            {
+                colorMap->colorIndexRow( numColors, range,
+                    rowValues, rowIndexes, numColumns );
 
-                if ( hasGaps && qwtIsNaN( value ) )
+                for ( int i = 0; i < numColumns; i++ )
                 {
-                    *line++ = 0u;
-                }
-                else if ( numColors == 0 )
-                {
-                    *line++ = colorMap->rgb( range, value );
-                }
-                else
-                {
-                    const uint index = colorMap->colorIndex( numColors, range, value );
-                    *line++ = rgbTable[index];
+                    if ( hasGaps && qwtIsNaN( rowValues[i] ) )
+                        *line++ = 0u;
+                    else
+                        *line++ = rgbTable[ rowIndexes[i] ];
                 }
             }
         }
     }
-    else if ( d_data->colorMap->format() == QwtColorMap::Indexed )
+    else if ( colorMap->format() == QwtColorMap::Indexed )
     {
         for ( int y = tile.top(); y <= tile.bottom(); y++ )
         {
             const double ty = yMap.invTransform( y );
+            d_data->data->valueRow( ty, tx, rowValues, numColumns );
+
+            // NaN values are mapped to 0 by colorIndexRow()
+            colorMap->colorIndexRow( 256, range,
+                rowValues, rowIndexes, numColumns );
 
             unsigned char *line = image->scanLine( y );
             line += tile.left();
 
-            for ( int x = tile.left(); x <= tile.right(); x++ )
-            {
-                const double tx = xMap.invTransform( x );
-
-                const double value = d_data->data->value( tx, ty );
-
-                if ( hasGaps && qwtIsNaN( value ) )
-                {
-                    *line++ = 0;
-                }
-                else
-                {
-                    const uint index = d_data->colorMap->colorIndex( 256, range, value );
-                    *line++ = static_cast<unsigned char>( index );
-                }
-            }
+            for ( int i = 0; i < numColumns; i++ )
+                *line++ = static_cast<unsigned char>( rowIndexes[i] );
         }
     }
 }
@@ -653,6 +687,8 @@ QSize QwtPlotSpectrogram::contourRasterSize(
    \param raster Raster, used by the CONREC algorithm
    \return Calculated contour lines
 
+   \note draw() uses renderContourPolylines() instead, when
+         QwtRasterData::JoinPolylines is enabled
    \sa contourLevels(), setConrecFlag(),
        QwtRasterData::contourLines()
 */
@@ -710,6 +746,85 @@ void QwtPlotSpectrogram::drawContourLines( QPainter *painter,
     }
 }
 
+/*!
+   \brief Calculate contour lines joined to polylines
+
+   The contour lines are calculated by renderThreadCount() threads
+   of threadPool(). renderContourPolylines() is used by draw()
+   instead of renderContourLines(), when QwtRasterData::JoinPolylines
+   is enabled.
+
+   \param rect Rectangle, where to calculate the contour lines
+   \param raster Raster, used by the CONREC algorithm
+   \return Calculated contour lines
+
+   \sa contourLevels(), setConrecFlag(), drawContourPolylines(),
+       QwtRasterData::contourPolylines()
+*/
+QwtRasterData::ContourPolylines QwtPlotSpectrogram::renderContourPolylines(
+    const QRectF &rect, const QSize &raster ) const
+{
+    if ( d_data->data == NULL )
+        return QwtRasterData::ContourPolylines();
+
+    return d_data->data->contourPolylines( rect, raster,
+        d_data->contourLevels, d_data->conrecFlags,
+        renderThreadCount(), threadPool() );
+}
+
+/*!
+   Paint the contour lines
+
+   \param painter Painter
+   \param xMap Maps x-values into pixel coordinates.
+   \param yMap Maps y-values into pixel coordinates.
+   \param contourLines Contour lines
+
+   \sa renderContourPolylines(), defaultContourPen(), contourPen()
+*/
+void QwtPlotSpectrogram::drawContourPolylines( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtRasterData::ContourPolylines &contourLines ) const
+{
+    if ( d_data->data == NULL )
+        return;
+
+    const int numLevels = d_data->contourLevels.size();
+    for ( int l = 0; l < numLevels; l++ )
+    {
+        const double level = d_data->contourLevels[l];
+
+        QwtRasterData::ContourPolylines::const_iterator it =
+            contourLines.constFind( level );
+        if ( it == contourLines.constEnd() )
+            continue;
+
+        QPen pen = defaultContourPen();
+        if ( pen.style() == Qt::NoPen )
+            pen = contourPen( level );
+
+        if ( pen.style() == Qt::NoPen )
+            continue;
+
+        painter->setPen( pen );
+
+        const QList<QPolygonF> &lines = it.value();
+        for ( int i = 0; i < lines.size(); i++ )
+        {
+            const QPolygonF &line = lines[i];
+
+            QPolygonF polyline( line.size() );
+            for ( int j = 0; j < line.size(); j++ )
+            {
+                polyline[j] = QPointF( xMap.transform( line[j].x() ),
+                    yMap.transform( line[j].y() ) );
+            }
+
+            QwtPainter::drawPolyline( painter, polyline );
+        }
+    }
+}
+
 /*!
   \brief Draw the spectrogram
 
@@ -718,8 +833,8 @@ void QwtPlotSpectrogram::drawContourLines( QPainter *painter,
   \param yMap Maps y-values into pixel coordinates.
   \param canvasRect Contents rectangle of the canvas in painter coordinates
 
-  \sa setDisplayMode(), renderImage(),
-      QwtPlotRasterItem::draw(), drawContourLines()
+  \sa setDisplayMode(), renderImage(), setConrecFlag(),
+      QwtPlotRasterItem::draw(), drawContourLines(), drawContourPolylines()
 */
 void QwtPlotSpectrogram::draw( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -751,10 +866,73 @@ void QwtPlotSpectrogram::draw( QPainter *painter,
         raster = raster.boundedTo( rasterRect.toRect().size() );
         if ( raster.isValid() )
         {
-            const QwtRasterData::ContourLines lines =
-                renderContourLines( area, raster );
+            const bool joinPolylines =
+                testConrecFlag( QwtRasterData::JoinPolylines );
+
+            if ( cachePolicy() == QwtPlotRasterItem::PaintCache )
+            {
+                /*
+                    The lines are cached in plot coordinates and can
+                    be reused as long as the resolution does not change.
+                    To survive panning they are calculated for an
+                    area with some extra margins.
+                 */
+                PrivateData::ContourCache &cache = d_data->contourCache;
+
+                if ( !cache.isValid( area, raster ) )
+                {
+                    const double dx = area.width() / raster.width();
+                    const double dy = area.height() / raster.height();
+
+                    const double mx = 0.25 * area.width();
+                    const double my = 0.25 * area.height();
+
+                    QRectF cacheArea = area.adjusted( -mx, -my, mx, my );
+                    if ( br.isValid() )
+                        cacheArea &= br;
+
+                    const QSize cacheRaster( qwtCeil( cacheArea.width() / dx ),
+                        qwtCeil( cacheArea.height() / dy ) );
+
+                    // keeping exactly the same resolution
+                    cacheArea.setWidth( cacheRaster.width() * dx );
+                    cacheArea.setHeight( cacheRaster.height() * dy );
+
+                    if ( joinPolylines )
+                    {
+                        cache.polylines =
+                            renderContourPolylines( cacheArea, cacheRaster );
+                    }
+                    else
+                    {
+                        cache.lines =
+                            renderContourLines( cacheArea, cacheRaster );
+                    }
+
+                    cache.area = cacheArea;
+                    cache.dx = dx;
+                    cache.dy = dy;
+                }
+
+                if ( joinPolylines )
+                    drawContourPolylines( painter, xMap, yMap, cache.polylines );
+                else
+                    drawContourLines( painter, xMap, yMap, cache.lines );
+            }
+            else if ( joinPolylines )
+            {
+                const QwtRasterData::ContourPolylines lines =
+                    renderContourPolylines( area, raster );
+
+                drawContourPolylines( painter, xMap, yMap, lines );
+            }
+            else
+            {
+                const QwtRasterData::ContourLines lines =
+                    renderContourLines( area, raster );
 
-            drawContourLines( painter, xMap, yMap, lines );
+                drawContourLines( painter, xMap, yMap, lines );
+            }
         }
     }
 }
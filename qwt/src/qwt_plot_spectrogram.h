@@ -87,6 +87,8 @@ public:
     void setContourLevels( const QList<double> & );
     QList<double> contourLevels() const;
 
+    virtual void invalidateCache() QWT_OVERRIDE;
+
     virtual int rtti() const QWT_OVERRIDE;
 
     virtual void draw( QPainter *,
@@ -108,8 +110,15 @@ protected:
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtRasterData::ContourLines& ) const;
 
-    void renderTile( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-        const QRect &tile, QImage * ) const;
+    virtual QwtRasterData::ContourPolylines renderContourPolylines(
+        const QRectF &rect, const QSize &raster ) const;
+
+    virtual void drawContourPolylines( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtRasterData::ContourPolylines& ) const;
+
+    virtual void renderTile( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRect &tile, QImage * ) const QWT_OVERRIDE;
 
 private:
     class PrivateData;
@@ -269,5 +269,7 @@ QRectF QwtPlotTextLabel::textRect(
 //!  Invalidate all internal cache
 void QwtPlotTextLabel::invalidateCache()
 {
+    waitForFrame();
+
     d_data->pixmap = QPixmap();
 }
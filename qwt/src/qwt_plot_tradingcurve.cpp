@@ -13,6 +13,8 @@
 #include "qwt_text.h"
 #include "qwt_graphic.h"
 #include "qwt_math.h"
+#include "qwt_point_index.h"
+#include "qwt_plot.h"
 
 #include <qpainter.h>
 
@@ -28,6 +30,17 @@ static inline bool qwtIsSampleInside( const QwtOHLCSample &sample,
     return !isOffScreen;
 }
 
+static inline QPointF qwtCenter(
+    const QwtOHLCSample &sample, bool isVertical )
+{
+    const double center = 0.5 * ( sample.low + sample.high );
+
+    if ( isVertical )
+        return QPointF( sample.time, center );
+
+    return QPointF( center, sample.time );
+}
+
 class QwtPlotTradingCurve::PrivateData
 {
 public:
@@ -36,12 +49,19 @@ public:
         symbolExtent( 0.6 ),
         minSymbolWidth( 2.0 ),
         maxSymbolWidth( -1.0 ),
-        paintAttributes( QwtPlotTradingCurve::ClipSymbols )
+        paintAttributes( QwtPlotTradingCurve::ClipSymbols ),
+        pointIndex( NULL ),
+        indexOrientation( Qt::Vertical )
     {
         symbolBrush[0] = QBrush( Qt::white );
         symbolBrush[1] = QBrush( Qt::black );
     }
 
+    ~PrivateData()
+    {
+        delete pointIndex;
+    }
+
     QwtPlotTradingCurve::SymbolStyle symbolStyle;
     double symbolExtent;
     double minSymbolWidth;
@@ -51,6 +71,10 @@ public:
     QBrush symbolBrush[2]; // Increasing/Decreasing
 
     QwtPlotTradingCurve::PaintAttributes paintAttributes;
+
+    // positions of the centers of the symbols
+    QwtPointIndex *pointIndex;
+    Qt::Orientation indexOrientation;
 };
 
 /*!
@@ -84,6 +108,7 @@ void QwtPlotTradingCurve::init()
 {
     setItemAttribute( QwtPlotItem::Legend, true );
     setItemAttribute( QwtPlotItem::AutoScale, true );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     d_data = new PrivateData;
     setData( new QwtTradingChartData() );
@@ -371,6 +396,117 @@ QRectF QwtPlotTradingCurve::boundingRect() const
     return rect;
 }
 
+/*!
+   \brief En/Disable a spatial index for closestPoint()
+
+   Without an index closestPoint() iterates over all samples.
+
+   The index is built with the next lookup and needs additional memory
+   for a copy of the centers of the symbols. Samples, that have been
+   appended later, are added incrementally.
+
+   \param on On/Off
+   \sa isPointIndexEnabled(), closestPoint(), QwtPointIndex
+*/
+void QwtPlotTradingCurve::setPointIndexEnabled( bool on )
+{
+    if ( on == isPointIndexEnabled() )
+        return;
+
+    if ( on )
+    {
+        d_data->pointIndex = new QwtPointIndex();
+    }
+    else
+    {
+        delete d_data->pointIndex;
+        d_data->pointIndex = NULL;
+    }
+}
+
+/*!
+   \return True, when a spatial index is used for closestPoint()
+   \sa setPointIndexEnabled()
+*/
+bool QwtPlotTradingCurve::isPointIndexEnabled() const
+{
+    return d_data->pointIndex != NULL;
+}
+
+/*!
+  Find the closest sample for a specific position
+
+  The distance is measured to the center of the symbols -
+  the middle between low and high.
+
+  \param pos Position, where to look for the closest sample
+  \param dist If dist != NULL, closestPoint() returns the distance between
+              the position and the center of the closest symbol
+  \return Index of the closest sample, or -1 if none can be found
+
+  \note Without a point index closestPoint() iterates over all samples
+  \sa setPointIndexEnabled()
+*/
+int QwtPlotTradingCurve::closestPoint( const QPoint &pos, double *dist ) const
+{
+    const int numSamples = static_cast<int>( dataSize() );
+
+    if ( plot() == NULL || numSamples <= 0 )
+        return -1;
+
+    const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
+    const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
+
+    const bool isVertical = ( orientation() == Qt::Vertical );
+
+    QwtPointIndex *pointIndex = d_data->pointIndex;
+    if ( pointIndex == NULL )
+    {
+        int index = -1;
+        double dmin = 1.0e10;
+
+        for ( int i = 0; i < numSamples; i++ )
+        {
+            const QPointF p = qwtCenter( sample( i ), isVertical );
+
+            const double cx = xMap.transform( p.x() ) - pos.x();
+            const double cy = yMap.transform( p.y() ) - pos.y();
+
+            const double f = qwtSqr( cx ) + qwtSqr( cy );
+            if ( f < dmin )
+            {
+                index = i;
+                dmin = f;
+            }
+        }
+
+        if ( dist )
+            *dist = std::sqrt( dmin );
+
+        return index;
+    }
+
+    if ( pointIndex->size() > numSamples
+        || d_data->indexOrientation != orientation() )
+    {
+        pointIndex->clear();
+        d_data->indexOrientation = orientation();
+    }
+
+    for ( int i = pointIndex->size(); i < numSamples; i++ )
+        pointIndex->append( qwtCenter( sample( i ), isVertical ) );
+
+    return pointIndex->closestPoint( xMap, yMap, pos, dist );
+}
+
+//! Invalidate the point index and update the plot
+void QwtPlotTradingCurve::dataChanged()
+{
+    if ( d_data->pointIndex )
+        d_data->pointIndex->clear();
+    QwtPlotSeriesItem::dataChanged();
+}
+
 /*!
   Draw an interval of the curve
 
@@ -133,18 +133,25 @@ public:
     void setMaxSymbolWidth( double );
     double maxSymbolWidth() const;
 
+    void setPointIndexEnabled( bool on );
+    bool isPointIndexEnabled() const;
+
     virtual void drawSeries( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const QWT_OVERRIDE;
 
     virtual QRectF boundingRect() const QWT_OVERRIDE;
 
+    virtual int closestPoint( const QPoint &pos, double *dist = NULL ) const;
+
     virtual QwtGraphic legendIcon( int index, const QSizeF & ) const QWT_OVERRIDE;
 
 protected:
 
     void init();
 
+    virtual void dataChanged() QWT_OVERRIDE;
+
     virtual void drawSymbols( QPainter *,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasRect, int from, int to ) const;
@@ -194,6 +194,7 @@ public:
         indicatorOrigin( QwtPlotVectorField::OriginHead ),
         magnitudeScaleFactor( 1.0 ),
         rasterSize( 20, 20 ),
+        paintAttributes( 0 ),
         magnitudeModes( MagnitudeAsLength )
     {
     }
@@ -244,6 +245,7 @@ void QwtPlotVectorField::init()
 {
     setItemAttribute( QwtPlotItem::Legend );
     setItemAttribute( QwtPlotItem::AutoScale );
+    setItemAttribute( QwtPlotItem::Scrollable );
 
     d_data = new PrivateData;
     setData( new QwtVectorFieldData() );
@@ -346,6 +348,11 @@ void QwtPlotVectorField::setPaintAttribute(
     if ( d_data->paintAttributes != attributes )
     {
         d_data->paintAttributes = attributes;
+
+        // the raster of FilterVectors is not aligned to the scales
+        setItemAttribute( QwtPlotItem::Scrollable,
+            !( attributes & FilterVectors ) );
+
         itemChanged();
     }
 }
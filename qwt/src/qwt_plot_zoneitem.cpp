@@ -54,6 +54,7 @@ QwtPlotZoneItem::QwtPlotZoneItem():
 
     setItemAttribute( QwtPlotItem::AutoScale, false );
     setItemAttribute( QwtPlotItem::Legend, false );
+    setItemAttribute( QwtPlotItem::Scrollable, true );
 
     setZ( 5 );
 }
@@ -28,6 +28,9 @@ public:
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+
     const QVector<T> &xData() const;
     const QVector<T> &yData() const;
 
@@ -48,6 +51,9 @@ public:
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+
     const T *xData() const;
     const T *yData() const;
 
@@ -73,6 +79,9 @@ public:
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+
     const QVector<T> &yData() const;
 
 private:
@@ -94,6 +103,9 @@ public:
     virtual size_t size() const QWT_OVERRIDE;
     virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+
     const T *yData() const;
 
 private:
@@ -242,6 +254,27 @@ QPointF QwtPointArrayData<T>::sample( size_t index ) const
     return QPointF( d_x[int( index )], d_y[int( index )] );
 }
 
+/*!
+  Copy a block of consecutive samples
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+*/
+template <typename T>
+void QwtPointArrayData<T>::sampleBlock(
+    size_t from, size_t count, QPointF *samples ) const
+{
+    const T *x = d_x.constData() + from;
+    const T *y = d_y.constData() + from;
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        samples[i].rx() = x[i];
+        samples[i].ry() = y[i];
+    }
+}
+
 //! \return Array of the x-values
 template <typename T>
 const QVector<T> &QwtPointArrayData<T>::xData() const
@@ -303,6 +336,26 @@ QPointF QwtValuePointData<T>::sample( size_t index ) const
     return QPointF( index, d_y[int( index )] );
 }
 
+/*!
+  Copy a block of consecutive samples
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+*/
+template <typename T>
+void QwtValuePointData<T>::sampleBlock(
+    size_t from, size_t count, QPointF *samples ) const
+{
+    const T *y = d_y.constData() + from;
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        samples[i].rx() = from + i;
+        samples[i].ry() = y[i];
+    }
+}
+
 //! \return Array of the y-values
 template <typename T>
 const QVector<T> &QwtValuePointData<T>::yData() const
@@ -351,6 +404,27 @@ QPointF QwtCPointerData<T>::sample( size_t index ) const
     return QPointF( d_x[int( index )], d_y[int( index )] );
 }
 
+/*!
+  Copy a block of consecutive samples
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+*/
+template <typename T>
+void QwtCPointerData<T>::sampleBlock(
+    size_t from, size_t count, QPointF *samples ) const
+{
+    const T *x = d_x + from;
+    const T *y = d_y + from;
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        samples[i].rx() = x[i];
+        samples[i].ry() = y[i];
+    }
+}
+
 //! \return Array of the x-values
 template <typename T>
 const T *QwtCPointerData<T>::xData() const
@@ -404,6 +478,26 @@ QPointF QwtCPointerValueData<T>::sample( size_t index ) const
     return QPointF( index, d_y[ int( index ) ] );
 }
 
+/*!
+  Copy a block of consecutive samples
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+*/
+template <typename T>
+void QwtCPointerValueData<T>::sampleBlock(
+    size_t from, size_t count, QPointF *samples ) const
+{
+    const T *y = d_y + from;
+
+    for ( size_t i = 0; i < count; i++ )
+    {
+        samples[i].rx() = from + i;
+        samples[i].ry() = y[i];
+    }
+}
+
 //! \return Array of the y-values
 template <typename T>
 const T *QwtCPointerValueData<T>::yData() const
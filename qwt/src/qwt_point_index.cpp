@@ -0,0 +1,282 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_point_index.h"
+#include "qwt_scale_map.h"
+#include "qwt_math.h"
+
+#include <qvector.h>
+#include <qpoint.h>
+#include <qnumeric.h>
+
+#include <algorithm>
+
+namespace
+{
+    enum
+    {
+        // nodes with less points are checked one by one
+        LeafSize = 8,
+
+        // minimum number of unindexed points before rebuilding the tree
+        MinRebuildSize = 1024
+    };
+
+    class LessThan
+    {
+    public:
+        LessThan( const QPointF *points, int axis ):
+            d_points( points ),
+            d_axis( axis )
+        {
+        }
+
+        inline bool operator()( int index1, int index2 ) const
+        {
+            const QPointF &p1 = d_points[ index1 ];
+            const QPointF &p2 = d_points[ index2 ];
+
+            return ( d_axis == 0 ) ? ( p1.x() < p2.x() ) : ( p1.y() < p2.y() );
+        }
+
+    private:
+        const QPointF *d_points;
+        const int d_axis;
+    };
+
+    class Query
+    {
+    public:
+        Query( const QPointF *points,
+                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                const QPointF &pos ):
+            points( points ),
+            xMap( xMap ),
+            yMap( yMap ),
+            pos( pos ),
+            index( -1 ),
+            distance( 1.0e20 )
+        {
+            // the position in scale coordinates decides about the near side
+            scalePos.setX( xMap.invTransform( pos.x() ) );
+            scalePos.setY( yMap.invTransform( pos.y() ) );
+        }
+
+        inline void check( int i )
+        {
+            const QPointF &p = points[i];
+
+            const double dx = xMap.transform( p.x() ) - pos.x();
+            const double dy = yMap.transform( p.y() ) - pos.y();
+
+            const double d = qwtSqr( dx ) + qwtSqr( dy );
+            if ( d < distance )
+            {
+                index = i;
+                distance = d;
+            }
+        }
+
+        const QPointF *points;
+        const QwtScaleMap &xMap;
+        const QwtScaleMap &yMap;
+
+        const QPointF pos;
+        QPointF scalePos;
+
+        int index;
+        double distance;
+    };
+}
+
+class QwtPointIndex::PrivateData
+{
+public:
+    PrivateData():
+        numIndexed( 0 )
+    {
+    }
+
+    void build();
+    void build( int *from, int *to, int axis );
+
+    void search( Query &, const int *from, const int *to, int axis ) const;
+
+    // positions in the order of their appending
+    QVector<QPointF> points;
+
+    // indexes of the points ordered as a balanced k-d tree
+    QVector<int> tree;
+
+    // points[0, numIndexed[ have been considered for the tree
+    int numIndexed;
+};
+
+void QwtPointIndex::PrivateData::build()
+{
+    tree.clear();
+    tree.reserve( points.size() );
+
+    // NaN values break the ordering of the tree and can't be the closest point
+
+    for ( int i = 0; i < points.size(); i++ )
+    {
+        const QPointF &p = points[i];
+        if ( !( qIsNaN( p.x() ) || qIsNaN( p.y() ) ) )
+            tree += i;
+    }
+
+    numIndexed = points.size();
+
+    int *indexes = tree.data();
+    build( indexes, indexes + tree.size(), 0 );
+}
+
+void QwtPointIndex::PrivateData::build( int *from, int *to, int axis )
+{
+    while ( to - from > LeafSize )
+    {
+        int *middle = from + ( to - from ) / 2;
+
+        std::nth_element( from, middle, to,
+            LessThan( points.constData(), axis ) );
+
+        axis = 1 - axis;
+
+        build( from, middle, axis );
+        from = middle + 1;
+    }
+}
+
+void QwtPointIndex::PrivateData::search( Query &query,
+    const int *from, const int *to, int axis ) const
+{
+    while ( to - from > LeafSize )
+    {
+        const int *middle = from + ( to - from ) / 2;
+        query.check( *middle );
+
+        const QPointF &split = points[ *middle ];
+
+        double delta;
+        bool isLower;
+
+        if ( axis == 0 )
+        {
+            delta = query.xMap.transform( split.x() ) - query.pos.x();
+            isLower = query.scalePos.x() < split.x();
+        }
+        else
+        {
+            delta = query.yMap.transform( split.y() ) - query.pos.y();
+            isLower = query.scalePos.y() < split.y();
+        }
+
+        axis = 1 - axis;
+
+        /*
+            As the maps are monotonic, all points on the far side
+            have at least a distance of delta in paint device coordinates.
+         */
+        if ( isLower )
+        {
+            search( query, from, middle, axis );
+
+            if ( qwtSqr( delta ) >= query.distance )
+                return;
+
+            from = middle + 1;
+        }
+        else
+        {
+            search( query, middle + 1, to, axis );
+
+            if ( qwtSqr( delta ) >= query.distance )
+                return;
+
+            to = middle;
+        }
+    }
+
+    for ( const int *it = from; it < to; it++ )
+        query.check( *it );
+}
+
+//! Constructor
+QwtPointIndex::QwtPointIndex()
+{
+    d_data = new PrivateData();
+}
+
+//! Destructor
+QwtPointIndex::~QwtPointIndex()
+{
+    delete d_data;
+}
+
+//! Remove all positions
+void QwtPointIndex::clear()
+{
+    d_data->points.clear();
+    d_data->tree.clear();
+    d_data->numIndexed = 0;
+}
+
+/*!
+  \brief Append a position
+
+  The index of the position is the number of positions, that
+  have been appended before.
+
+  \param pos Position in scale coordinates
+ */
+void QwtPointIndex::append( const QPointF &pos )
+{
+    d_data->points += pos;
+}
+
+//! \return Number of positions
+int QwtPointIndex::size() const
+{
+    return d_data->points.size();
+}
+
+/*!
+  \brief Find the closest position
+
+  \param xMap Maps x coordinates into paint device coordinates
+  \param yMap Maps y coordinates into paint device coordinates
+  \param pos Position in paint device coordinates
+  \param dist If dist != NULL, closestPoint() returns the distance between
+              pos and the closest position in paint device coordinates
+
+  \return Index of the closest position or -1, when the index is empty
+ */
+int QwtPointIndex::closestPoint( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPointF &pos, double *dist ) const
+{
+    PrivateData *d = d_data;
+
+    const int numPending = d->points.size() - d->numIndexed;
+    if ( numPending > qMax( int( MinRebuildSize ), d->numIndexed / 4 ) )
+        d->build();
+
+    Query query( d->points.constData(), xMap, yMap, pos );
+
+    const int *indexes = d->tree.constData();
+    d->search( query, indexes, indexes + d->tree.size(), 0 );
+
+    for ( int i = d->numIndexed; i < d->points.size(); i++ )
+        query.check( i );
+
+    if ( dist )
+        *dist = ( query.index >= 0 ) ? std::sqrt( query.distance ) : 0.0;
+
+    return query.index;
+}
@@ -0,0 +1,56 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_POINT_INDEX_H
+#define QWT_POINT_INDEX_H
+
+#include "qwt_global.h"
+
+class QwtScaleMap;
+class QPointF;
+
+/*!
+  \brief A spatial index for finding the closest point of a set of points
+
+  QwtPointIndex organizes the positions of the samples of a plot item
+  in a k-d tree in scale coordinates. As the distance is measured in
+  paint device coordinates, the scale maps are passed to closestPoint().
+  Any type of transformation is supported as long as it is monotonic,
+  so that the same index can be used for all zoom levels.
+
+  Positions, that are appended after the tree has been built, are
+  checked one by one, until there are enough of them to make a rebuild
+  of the tree worth it. So appending positions is cheap, but modifying
+  or removing them requires to clear() the index.
+
+  The index is used by QwtPlotCurve, QwtPlotIntervalCurve and
+  QwtPlotTradingCurve to implement their closestPoint() lookups.
+ */
+class QWT_EXPORT QwtPointIndex
+{
+public:
+    QwtPointIndex();
+    ~QwtPointIndex();
+
+    void clear();
+    void append( const QPointF & );
+
+    int size() const;
+
+    int closestPoint( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, double *dist = NULL ) const;
+
+private:
+    Q_DISABLE_COPY(QwtPointIndex)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -43,6 +43,77 @@ static inline double qwtRoundValueF( double value )
 #endif
 }
 
+namespace
+{
+    /*
+        Reading samples block by block and mapping them
+        with QwtScaleMap::transformBlock(), so that there
+        are no virtual calls for each sample
+     */
+    class QwtMappedSampleReader
+    {
+    public:
+        enum { BlockSize = 128 };
+
+        QwtMappedSampleReader(
+                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                const QwtSeriesData<QPointF> *series, int from, int to ):
+            d_xMap( xMap ),
+            d_yMap( yMap ),
+            d_series( series ),
+            d_index( from ),
+            d_to( to ),
+            d_pos( 0 ),
+            d_count( 0 )
+        {
+        }
+
+        inline void next( double &x, double &y )
+        {
+            if ( d_pos == d_count )
+                fetch();
+
+            x = d_x[ d_pos ];
+            y = d_y[ d_pos ];
+
+            d_pos++;
+        }
+
+    private:
+        void fetch()
+        {
+            d_count = qMin( static_cast<int>( BlockSize ), d_to - d_index + 1 );
+            d_series->sampleBlock( d_index, d_count, d_samples );
+
+            for ( int i = 0; i < d_count; i++ )
+            {
+                d_x[i] = d_samples[i].x();
+                d_y[i] = d_samples[i].y();
+            }
+
+            d_xMap.transformBlock( d_x, d_x, d_count );
+            d_yMap.transformBlock( d_y, d_y, d_count );
+
+            d_index += d_count;
+            d_pos = 0;
+        }
+
+        const QwtScaleMap &d_xMap;
+        const QwtScaleMap &d_yMap;
+        const QwtSeriesData<QPointF> *d_series;
+
+        int d_index;
+        const int d_to;
+
+        int d_pos;
+        int d_count;
+
+        QPointF d_samples[ BlockSize ];
+        double d_x[ BlockSize ];
+        double d_y[ BlockSize ];
+    };
+}
+
 static Qt::Orientation qwtProbeOrientation(
     const QwtSeriesData<QPointF> *series, int from, int to )
 {
@@ -193,13 +264,16 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
     q.start( qwtRoundValue( xMap.transform( sample0.x() ) ),
         qwtRoundValue( yMap.transform( sample0.y() ) ) );
 
+    QwtMappedSampleReader reader( xMap, yMap, series, from, to );
+
     Polygon polyline;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        double xi, yi;
+        reader.next( xi, yi );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( xi );
+        const int y = qwtRoundValue( yi );
 
         if ( !q.append( x, y ) )
         {
@@ -302,12 +376,16 @@ static void qwtRenderDots(
     const int x0 = pos.x();
     const int y0 = pos.y();
 
+    QwtMappedSampleReader reader( xMap, yMap,
+        command.series, command.from, command.to );
+
     for ( int i = command.from; i <= command.to; i++ )
     {
-        const QPointF sample = command.series->sample( i );
+        double xi, yi;
+        reader.next( xi, yi );
 
-        const int x = static_cast<int>( xMap.transform( sample.x() ) + 0.5 ) - x0;
-        const int y = static_cast<int>( yMap.transform( sample.y() ) + 0.5 ) - y0;
+        const int x = static_cast<int>( xi + 0.5 ) - x0;
+        const int y = static_cast<int>( yi + 0.5 ) - y0;
 
         if ( x >= 0 && x < w && y >= 0 && y < h )
             bits[ y * w + x ] = rgb;
@@ -354,6 +432,8 @@ static inline Polygon qwtToPoints(
 
     int numPoints = 0;
 
+    QwtMappedSampleReader reader( xMap, yMap, series, from, to );
+
     if ( boundingRect.isValid() )
     {
         // iterating over all values
@@ -362,10 +442,8 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
-
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
+            double x, y;
+            reader.next( x, y );
 
             if ( boundingRect.contains( x, y ) )
             {
@@ -385,10 +463,8 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
-
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
+            double x, y;
+            reader.next( x, y );
 
             points[ numPoints ].rx() = round( x );
             points[ numPoints ].ry() = round( y );
@@ -443,13 +519,15 @@ static inline Polygon qwtToPolylineFiltered(
     points[0].rx() = round( xMap.transform( sample0.x() ) );
     points[0].ry() = round( yMap.transform( sample0.y() ) );
 
+    QwtMappedSampleReader reader( xMap, yMap, series, from + 1, to );
+
     int pos = 0;
     for ( int i = from + 1; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        double x, y;
+        reader.next( x, y );
 
-        const Point p( round( xMap.transform( sample.x() ) ),
-            round( yMap.transform( sample.y() ) ) );
+        const Point p( round( x ), round( y ) );
 
         if ( points[pos] != p )
             points[++pos] = p;
@@ -492,13 +570,16 @@ static inline Polygon qwtToPointsFiltered(
 
     QwtPixelMatrix pixelMatrix( boundingRect.toAlignedRect() );
 
+    QwtMappedSampleReader reader( xMap, yMap, series, from, to );
+
     int numPoints = 0;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        double xi, yi;
+        reader.next( xi, yi );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( xi );
+        const int y = qwtRoundValue( yi );
 
         if ( pixelMatrix.testAndSetPixel( x, y, true ) == false )
         {
@@ -0,0 +1,554 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_pyramid_point_data.h"
+#include "qwt_scale_map.h"
+#include "qwt_math.h"
+
+#include <qpolygon.h>
+
+namespace
+{
+    class Bucket
+    {
+    public:
+        int minIndex;
+        int maxIndex;
+
+        double yMin;
+        double yMax;
+    };
+
+    /*
+        Collecting the samples/buckets, that are mapped to
+        the same pixel column and reducing them to 4 samples:
+        first, minimum, maximum, last
+     */
+    class ColumnReducer
+    {
+    public:
+        ColumnReducer( const QwtSeriesData<QPointF> *series,
+                const QwtScaleMap &xMap, QPolygonF &samples ):
+            d_series( series ),
+            d_xMap( xMap ),
+            d_samples( samples ),
+            d_isEmpty( true )
+        {
+        }
+
+        inline void addSample( int index )
+        {
+            const QPointF sample = d_series->sample( index );
+            add( index, index, index, sample.y(), index, sample.y(), sample.x() );
+        }
+
+        inline void addBucket( int first, int last, const Bucket &bucket )
+        {
+            const double x = d_series->sample( first ).x();
+
+            add( first, last, bucket.minIndex, bucket.yMin,
+                bucket.maxIndex, bucket.yMax, x );
+        }
+
+        inline void flush()
+        {
+            if ( d_isEmpty )
+                return;
+
+            int indexes[4] = { d_first, d_minIndex, d_maxIndex, d_last };
+            if ( indexes[1] > indexes[2] )
+                qSwap( indexes[1], indexes[2] );
+
+            int lastIndex = -1;
+            for ( int i = 0; i < 4; i++ )
+            {
+                if ( indexes[i] != lastIndex )
+                {
+                    d_samples += d_series->sample( indexes[i] );
+                    lastIndex = indexes[i];
+                }
+            }
+
+            d_isEmpty = true;
+        }
+
+    private:
+        inline void add( int first, int last,
+            int minIndex, double yMin, int maxIndex, double yMax, double x )
+        {
+            const int column = qRound( d_xMap.transform( x ) );
+
+            if ( !d_isEmpty && column == d_column )
+            {
+                if ( yMin < d_yMin )
+                {
+                    d_yMin = yMin;
+                    d_minIndex = minIndex;
+                }
+
+                if ( yMax > d_yMax )
+                {
+                    d_yMax = yMax;
+                    d_maxIndex = maxIndex;
+                }
+
+                d_last = last;
+                return;
+            }
+
+            flush();
+
+            d_column = column;
+            d_first = first;
+            d_last = last;
+            d_minIndex = minIndex;
+            d_maxIndex = maxIndex;
+            d_yMin = yMin;
+            d_yMax = yMax;
+
+            d_isEmpty = false;
+        }
+
+        const QwtSeriesData<QPointF> *d_series;
+        const QwtScaleMap &d_xMap;
+        QPolygonF &d_samples;
+
+        bool d_isEmpty;
+        int d_column;
+        int d_first;
+        int d_last;
+        int d_minIndex;
+        int d_maxIndex;
+        double d_yMin;
+        double d_yMax;
+    };
+}
+
+static inline void qwtMergeBuckets( const Bucket &b1, const Bucket &b2,
+    Bucket &bucket )
+{
+    if ( b2.yMin < b1.yMin )
+    {
+        bucket.yMin = b2.yMin;
+        bucket.minIndex = b2.minIndex;
+    }
+    else
+    {
+        bucket.yMin = b1.yMin;
+        bucket.minIndex = b1.minIndex;
+    }
+
+    if ( b2.yMax > b1.yMax )
+    {
+        bucket.yMax = b2.yMax;
+        bucket.maxIndex = b2.maxIndex;
+    }
+    else
+    {
+        bucket.yMax = b1.yMax;
+        bucket.maxIndex = b1.maxIndex;
+    }
+}
+
+class QwtPyramidPointData::PrivateData
+{
+public:
+    PrivateData( QwtSeriesData<QPointF> *s, int size ):
+        series( s ),
+        blockSize( qMax( size, 2 ) ),
+        numSamples( 0 )
+    {
+    }
+
+    ~PrivateData()
+    {
+        delete series;
+    }
+
+    inline int bucketSize( int level ) const
+    {
+        return blockSize << level;
+    }
+
+    void addRange( ColumnReducer &reducer, int level, int from, int to ) const
+    {
+        if ( from > to )
+            return;
+
+        if ( level < 0 )
+        {
+            for ( int i = from; i <= to; i++ )
+                reducer.addSample( i );
+
+            return;
+        }
+
+        const QVector<Bucket> &buckets = levels[level];
+        const int size = bucketSize( level );
+
+        const int b1 = ( from + size - 1 ) / size;
+
+        int b2;
+        if ( to == numSamples - 1 )
+            b2 = buckets.size() - 1; // including a partial last bucket
+        else
+            b2 = ( to + 1 ) / size - 1;
+
+        if ( b1 > b2 )
+        {
+            addRange( reducer, level - 1, from, to );
+            return;
+        }
+
+        addRange( reducer, level - 1, from, b1 * size - 1 );
+
+        for ( int b = b1; b <= b2; b++ )
+        {
+            const int first = b * size;
+            const int last = qMin( first + size, numSamples ) - 1;
+
+            reducer.addBucket( first, last, buckets[b] );
+        }
+
+        addRange( reducer, level - 1, ( b2 + 1 ) * size, to );
+    }
+
+    inline bool isOutdated() const
+    {
+        return series && numSamples != static_cast<int>( series->size() );
+    }
+
+    void update()
+    {
+        const int size = series ? static_cast<int>( series->size() ) : 0;
+        if ( size < numSamples )
+            levels.clear();
+
+        if ( size <= 0 )
+        {
+            levels.clear();
+            numSamples = 0;
+            return;
+        }
+
+        const int oldNumSamples = levels.isEmpty() ? 0 : numSamples;
+
+        if ( levels.isEmpty() )
+            levels.resize( 1 );
+
+        // the lowest level is calculated from the samples
+
+        QVector<Bucket> &buckets0 = levels[0];
+
+        int dirty = oldNumSamples / blockSize;
+        buckets0.resize( ( size + blockSize - 1 ) / blockSize );
+
+        QwtSampleBlockReader<QPointF> reader(
+            series, dirty * blockSize, size - 1 );
+
+        for ( int b = dirty; b < buckets0.size(); b++ )
+        {
+            const int first = b * blockSize;
+            const int last = qMin( first + blockSize, size ) - 1;
+
+            Bucket &bucket = buckets0[b];
+
+            const double y0 = reader.next().y();
+
+            bucket.minIndex = bucket.maxIndex = first;
+            bucket.yMin = bucket.yMax = y0;
+
+            for ( int i = first + 1; i <= last; i++ )
+            {
+                const double y = reader.next().y();
+
+                if ( y < bucket.yMin )
+                {
+                    bucket.yMin = y;
+                    bucket.minIndex = i;
+                }
+                else if ( y > bucket.yMax )
+                {
+                    bucket.yMax = y;
+                    bucket.maxIndex = i;
+                }
+            }
+        }
+
+        // all other levels are merging 2 buckets of the level below
+
+        int level = 1;
+        while ( levels[level - 1].size() > 1 )
+        {
+            if ( level >= levels.size() )
+                levels.resize( level + 1 );
+
+            const QVector<Bucket> &children = levels[level - 1];
+            QVector<Bucket> &buckets = levels[level];
+
+            dirty = qMin( dirty / 2, buckets.size() );
+            buckets.resize( ( children.size() + 1 ) / 2 );
+
+            for ( int b = dirty; b < buckets.size(); b++ )
+            {
+                const int child = 2 * b;
+
+                if ( child + 1 < children.size() )
+                    qwtMergeBuckets( children[child], children[child + 1], buckets[b] );
+                else
+                    buckets[b] = children[child];
+            }
+
+            level++;
+        }
+
+        levels.resize( level );
+        numSamples = size;
+    }
+
+    QwtSeriesData<QPointF> *series;
+    const int blockSize;
+
+    int numSamples;
+    QVector< QVector<Bucket> > levels;
+};
+
+/*!
+  Constructor
+
+  \param series Series to be decorated. The ownership
+                of the series is transferred to the pyramid
+  \param blockSize Number of samples of the buckets on the
+                   lowest level of the pyramid
+
+  \sa update()
+ */
+QwtPyramidPointData::QwtPyramidPointData(
+    QwtSeriesData<QPointF> *series, int blockSize )
+{
+    d_data = new PrivateData( series, blockSize );
+    update();
+}
+
+//! Destructor
+QwtPyramidPointData::~QwtPyramidPointData()
+{
+    delete d_data;
+}
+
+//! \return Decorated series
+const QwtSeriesData<QPointF> *QwtPyramidPointData::series() const
+{
+    return d_data->series;
+}
+
+//! \return Decorated series
+QwtSeriesData<QPointF> *QwtPyramidPointData::series()
+{
+    return d_data->series;
+}
+
+//! \return Number of samples of the buckets on the lowest level
+int QwtPyramidPointData::blockSize() const
+{
+    return d_data->blockSize;
+}
+
+//! \return Number of levels of the pyramid
+int QwtPyramidPointData::levelCount() const
+{
+    return d_data->levels.size();
+}
+
+/*!
+  \brief Update the pyramid for the current samples of the series
+
+  When the series has grown only the buckets for the appended samples
+  ( and the last incomplete bucket of each level ) are calculated.
+  Otherwise the complete pyramid is rebuilt.
+
+  There is no need to call update() after appending samples,
+  as the pyramid is updated lazily, when the number of samples
+  has changed.
+
+  \note Modifications of samples, that have already been processed,
+        are not detected. In this case invalidate() needs to
+        be called.
+
+  \sa invalidate()
+ */
+void QwtPyramidPointData::update()
+{
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    d_data->update();
+}
+
+/*!
+  Clear the pyramid, so that it is rebuilt completely with
+  the next update() or when it is needed for the next time
+
+  \sa update()
+ */
+void QwtPyramidPointData::invalidate()
+{
+    d_data->levels.clear();
+    d_data->numSamples = 0;
+
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+}
+
+//! \return Number of samples of the decorated series
+size_t QwtPyramidPointData::size() const
+{
+    return d_data->series ? d_data->series->size() : 0;
+}
+
+/*!
+  \param index Index
+  \return Sample of the decorated series at position index
+ */
+QPointF QwtPyramidPointData::sample( size_t index ) const
+{
+    return d_data->series->sample( index );
+}
+
+/*!
+  Copy a block of consecutive samples from the decorated series
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+ */
+void QwtPyramidPointData::sampleBlock(
+    size_t from, size_t count, QPointF *samples ) const
+{
+    d_data->series->sampleBlock( from, count, samples );
+}
+
+/*!
+  \brief Calculate the bounding rectangle
+
+  The bounding rectangle is calculated from the top of the
+  pyramid and the first and last sample. It is cached
+  until the pyramid gets updated.
+
+  \return Bounding rectangle
+ */
+QRectF QwtPyramidPointData::boundingRect() const
+{
+    if ( d_data->series == NULL )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    if ( d_data->isOutdated() )
+    {
+        // the number of samples has changed since the last update
+        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+        d_data->update();
+    }
+
+    if ( d_data->levels.isEmpty() )
+        return d_data->series->boundingRect();
+
+    if ( d_boundingRect.width() < 0.0 )
+    {
+        const Bucket &top = d_data->levels.last()[0];
+
+        const double x1 = d_data->series->sample( 0 ).x();
+        const double x2 = d_data->series->sample( d_data->numSamples - 1 ).x();
+
+        d_boundingRect.setCoords( qMin( x1, x2 ), top.yMin,
+            qMax( x1, x2 ), top.yMax );
+    }
+
+    return d_boundingRect;
+}
+
+/*!
+  Forward the rectangle of interest to the decorated series
+
+  \param rect Rectangle of interest
+ */
+void QwtPyramidPointData::setRectOfInterest( const QRectF &rect )
+{
+    if ( d_data->series )
+        d_data->series->setRectOfInterest( rect );
+}
+
+/*!
+  \brief Reduce an interval of samples to the samples, that are
+         relevant for drawing a polyline
+
+  For each pixel column - according to xMap - the first sample, the
+  samples with the minimal and maximal y coordinates and the last sample
+  are returned in the order of the series.
+
+  The level of the pyramid is chosen according to the number of samples
+  per pixel, so that the number of buckets and samples, that have to be
+  processed, is proportional to the width of the interval in pixels.
+
+  \param xMap Maps x-values into pixel coordinates.
+  \param from Index of the first sample
+  \param to Index of the last sample
+  \param samples Reduced samples
+
+  When the number of samples has changed since the last update()
+  the pyramid is updated before.
+
+  \return false, when the samples can't be reduced. This happens
+          when there are less samples per pixel than the blockSize()
+ */
+bool QwtPyramidPointData::decimatedSamples( const QwtScaleMap &xMap,
+    int from, int to, QPolygonF &samples ) const
+{
+    samples.clear();
+
+    const QwtSeriesData<QPointF> *series = d_data->series;
+    if ( series == NULL )
+        return false;
+
+    if ( d_data->isOutdated() )
+    {
+        // the number of samples has changed since the last update
+        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+        d_data->update();
+    }
+
+    if ( d_data->levels.isEmpty() )
+        return false;
+
+    from = qMax( from, 0 );
+    to = qMin( to, d_data->numSamples - 1 );
+
+    if ( from > to )
+        return false;
+
+    const double x1 = xMap.transform( series->sample( from ).x() );
+    const double x2 = xMap.transform( series->sample( to ).x() );
+
+    const double width = qMax( qAbs( x2 - x1 ), 1.0 );
+    const double samplesPerPixel = ( to - from + 1 ) / width;
+
+    if ( samplesPerPixel < d_data->blockSize )
+        return false;
+
+    int level = 0;
+    while ( level + 1 < d_data->levels.size() &&
+        d_data->bucketSize( level + 1 ) <= samplesPerPixel )
+    {
+        level++;
+    }
+
+    samples.reserve( 4 * ( qwtCeil( width ) + 1 ) );
+
+    ColumnReducer reducer( series, xMap, samples );
+    d_data->addRange( reducer, level, from, to );
+    reducer.flush();
+
+    return true;
+}
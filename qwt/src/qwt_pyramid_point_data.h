@@ -0,0 +1,86 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PYRAMID_POINT_DATA_H
+#define QWT_PYRAMID_POINT_DATA_H
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+
+class QwtScaleMap;
+class QPolygonF;
+
+/*!
+  \brief A decorator building a min/max pyramid for a series of points
+
+  QwtPyramidPointData wraps another QwtSeriesData<QPointF> and
+  builds a multi-resolution pyramid of buckets on top of it. Each bucket
+  stores the indexes of the samples with the minimum and maximum
+  y coordinates of a consecutive block of samples. The size of the
+  blocks doubles from level to level.
+
+  When drawing a curve with QwtPlotCurve::Lines, QwtPlotCurve detects
+  a QwtPyramidPointData and asks for decimatedSamples() instead
+  of mapping all samples of the series. For every pixel column
+  only the first, minimal, maximal and last sample are returned, so
+  that the cost for rendering depends on the width of the canvas
+  rather than on the number of samples.
+
+  The samples need to be sorted in increasing order of their
+  x coordinates.
+
+  \par Example
+  \code
+    QwtCPointerData<double> *raw =
+        new QwtCPointerData<double>( xValues, yValues, numValues );
+
+    QwtPlotCurve *curve = new QwtPlotCurve();
+    curve->setData( new QwtPyramidPointData( raw ) );
+  \endcode
+
+  \note When samples have been appended to the wrapped series the pyramid
+        is updated lazily, calculating only the buckets of the new samples.
+        After modifying samples in place invalidate() needs to be called.
+ */
+class QWT_EXPORT QwtPyramidPointData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtPyramidPointData( QwtSeriesData<QPointF> *series,
+        int blockSize = 64 );
+
+    virtual ~QwtPyramidPointData();
+
+    const QwtSeriesData<QPointF> *series() const;
+    QwtSeriesData<QPointF> *series();
+
+    int blockSize() const;
+    int levelCount() const;
+
+    void update();
+    void invalidate();
+
+    virtual size_t size() const QWT_OVERRIDE;
+    virtual QPointF sample( size_t index ) const QWT_OVERRIDE;
+    virtual void sampleBlock( size_t from,
+        size_t count, QPointF *samples ) const QWT_OVERRIDE;
+    virtual QRectF boundingRect() const QWT_OVERRIDE;
+
+    virtual void setRectOfInterest( const QRectF & ) QWT_OVERRIDE;
+
+    bool decimatedSamples( const QwtScaleMap &xMap,
+        int from, int to, QPolygonF &samples ) const;
+
+private:
+    Q_DISABLE_COPY(QwtPyramidPointData)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -16,6 +16,14 @@
 #include <qnumeric.h>
 #include <qlist.h>
 #include <qmap.h>
+#include <qvector.h>
+#include <qhash.h>
+#include <qthread.h>
+#include <qthreadpool.h>
+#include <qrunnable.h>
+#include <qsemaphore.h>
+
+#include <string.h>
 
 class QwtRasterData::ContourPlane
 {
@@ -161,6 +169,456 @@ inline QPointF QwtRasterData::ContourPlane::intersection(
     return QPointF( x, y );
 }
 
+namespace
+{
+    // a grid of raster.width() x raster.height() positions
+    class ContourGrid
+    {
+    public:
+        inline double y( int row ) const
+        {
+            return y0 + row * dy;
+        }
+
+        const QwtRasterData *data;
+
+        QVector<double> xValues;
+        double y0;
+        double dy;
+
+        QVector<double> levels;
+
+        QwtInterval range;
+        bool ignoreOutOfRange;
+        bool ignoreOnPlane;
+    };
+
+    // line segments - 2 points each - for every level
+    typedef QVector<QPolygonF> ContourSegments;
+
+    class PointKey
+    {
+    public:
+        explicit inline PointKey( const QPointF &pos ):
+            // adding 0.0 turns -0.0 into 0.0
+            x( pos.x() + 0.0 ),
+            y( pos.y() + 0.0 )
+        {
+        }
+
+        inline bool operator==( const PointKey &other ) const
+        {
+            return x == other.x && y == other.y;
+        }
+
+        double x;
+        double y;
+    };
+
+    inline uint qHash( const PointKey &key )
+    {
+        quint64 bits[2];
+        ::memcpy( bits, &key.x, sizeof( double ) );
+        ::memcpy( bits + 1, &key.y, sizeof( double ) );
+
+        const quint64 h = bits[0] ^ ( bits[1] * Q_UINT64_C( 0x9E3779B97F4A7C15 ) );
+        return static_cast<uint>( h ^ ( h >> 32 ) );
+    }
+}
+
+static ContourSegments qwtContourBand(
+    const ContourGrid *grid, int fromRow, int toRow )
+{
+    enum Position
+    {
+        Center,
+
+        TopLeft,
+        TopRight,
+        BottomRight,
+        BottomLeft,
+
+        NumPositions
+    };
+
+    const QVector<double> &levels = grid->levels;
+    const int numLevels = levels.size();
+
+    const double *x = grid->xValues.constData();
+    const int numColumns = grid->xValues.size();
+
+    // sampling the rows of the band once, instead of 4 times per cell
+
+    QVector<double> values( ( toRow - fromRow + 1 ) * numColumns );
+    for ( int row = fromRow; row <= toRow; row++ )
+    {
+        grid->data->valueRow( grid->y( row ), x,
+            values.data() + ( row - fromRow ) * numColumns, numColumns );
+    }
+
+    ContourSegments segments( numLevels );
+
+    QwtPoint3D xy[NumPositions];
+    QPointF line[2];
+    QwtPoint3D vertex[3];
+
+    for ( int row = fromRow; row < toRow; row++ )
+    {
+        const double *z1 = values.constData() + ( row - fromRow ) * numColumns;
+        const double *z2 = z1 + numColumns;
+
+        const double y1 = grid->y( row );
+        const double y2 = grid->y( row + 1 );
+
+        for ( int col = 0; col < numColumns - 1; col++ )
+        {
+            xy[TopLeft] = QwtPoint3D( x[col], y1, z1[col] );
+            xy[TopRight] = QwtPoint3D( x[col + 1], y1, z1[col + 1] );
+            xy[BottomRight] = QwtPoint3D( x[col + 1], y2, z2[col + 1] );
+            xy[BottomLeft] = QwtPoint3D( x[col], y2, z2[col] );
+
+            double zMin = xy[TopLeft].z();
+            double zMax = zMin;
+            double zSum = zMin;
+
+            for ( int i = TopRight; i <= BottomLeft; i++ )
+            {
+                const double z = xy[i].z();
+
+                zSum += z;
+                if ( z < zMin )
+                    zMin = z;
+                if ( z > zMax )
+                    zMax = z;
+            }
+
+            if ( qIsNaN( zSum ) )
+            {
+                // one of the points is NaN
+                continue;
+            }
+
+            if ( grid->ignoreOutOfRange )
+            {
+                if ( !grid->range.contains( zMin ) || !grid->range.contains( zMax ) )
+                    continue;
+            }
+
+            if ( zMax < levels[0] || zMin > levels[numLevels - 1] )
+                continue;
+
+            xy[Center] = QwtPoint3D( 0.5 * ( x[col] + x[col + 1] ),
+                0.5 * ( y1 + y2 ), 0.25 * zSum );
+
+            for ( int l = 0; l < numLevels; l++ )
+            {
+                const double level = levels[l];
+                if ( level < zMin || level > zMax )
+                    continue;
+
+                QPolygonF &lines = segments[l];
+                const QwtRasterData::ContourPlane plane( level );
+
+                for ( int m = TopLeft; m < NumPositions; m++ )
+                {
+                    vertex[0] = xy[m];
+                    vertex[1] = xy[0];
+                    vertex[2] = xy[m != BottomLeft ? m + 1 : TopLeft];
+
+                    const bool intersects =
+                        plane.intersect( vertex, line, grid->ignoreOnPlane );
+                    if ( intersects )
+                    {
+                        lines += line[0];
+                        lines += line[1];
+                    }
+                }
+            }
+        }
+    }
+
+    return segments;
+}
+
+static QList<QPolygonF> qwtJoinSegments( const QPolygonF &segments )
+{
+    /*
+        Neighbored cells calculate the intersections of their common
+        edges from the same vertices, so that the end points of
+        connected segments are identical and can be matched exactly.
+     */
+    const int numEnds = segments.size();
+
+    // the end of another segment at the same position
+    QVector<int> links( numEnds, -1 );
+    QVector<bool> done( numEnds / 2, false );
+
+    QHash<PointKey, int> openEnds;
+    openEnds.reserve( numEnds / 2 );
+
+    for ( int i = 0; i < numEnds; i += 2 )
+    {
+        const QPointF &p1 = segments[i];
+        const QPointF &p2 = segments[i + 1];
+
+        if ( p1.x() == p2.x() && p1.y() == p2.y() )
+        {
+            // degenerated segment
+            done[i / 2] = true;
+            continue;
+        }
+
+        for ( int j = i; j <= i + 1; j++ )
+        {
+            const PointKey key( segments[j] );
+
+            QHash<PointKey, int>::iterator it = openEnds.find( key );
+            if ( it == openEnds.end() )
+            {
+                openEnds.insert( key, j );
+            }
+            else
+            {
+                links[j] = it.value();
+                links[it.value()] = j;
+
+                openEnds.erase( it );
+            }
+        }
+    }
+
+    QList<QPolygonF> polylines;
+
+    for ( int i = 0; i < numEnds; i += 2 )
+    {
+        if ( done[i / 2] )
+            continue;
+
+        // walking backwards to the beginning of the chain,
+        // or around a closed loop until getting back to i
+
+        int start = i;
+        for ( int link = links[start]; link >= 0; link = links[start] )
+        {
+            start = link ^ 1;
+            if ( start == i )
+                break;
+        }
+
+        QPolygonF polyline;
+        polyline += segments[start];
+
+        for ( int end = start; ; )
+        {
+            done[end / 2] = true;
+            polyline += segments[end ^ 1];
+
+            end = links[end ^ 1];
+            if ( end < 0 || done[end / 2] )
+                break;
+        }
+
+        polylines += polyline;
+    }
+
+    return polylines;
+}
+
+#if !defined(QT_NO_QFUTURE)
+
+namespace
+{
+    class ContourTask: public QRunnable
+    {
+    public:
+        ContourTask():
+            done( NULL )
+        {
+            setAutoDelete( false );
+        }
+
+        virtual void run() QWT_OVERRIDE
+        {
+            execute();
+            done->release();
+        }
+
+        virtual void execute() = 0;
+
+        QSemaphore *done;
+    };
+
+    class BandTask: public ContourTask
+    {
+    public:
+        virtual void execute() QWT_OVERRIDE
+        {
+            segments = qwtContourBand( grid, fromRow, toRow );
+        }
+
+        const ContourGrid *grid;
+        int fromRow;
+        int toRow;
+
+        ContourSegments segments;
+    };
+
+    class JoinTask: public ContourTask
+    {
+    public:
+        virtual void execute() QWT_OVERRIDE
+        {
+            for ( int l = firstLevel; l < segments->size(); l += levelStep )
+            {
+                if ( !segments->at( l ).isEmpty() )
+                    polylines[l] = qwtJoinSegments( segments->at( l ) );
+            }
+        }
+
+        const ContourSegments *segments;
+        QList<QPolygonF> *polylines;
+
+        int firstLevel;
+        int levelStep;
+    };
+}
+
+static int qwtThreadCount( uint numThreads )
+{
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    return int( numThreads );
+}
+
+static void qwtRunTasks( const QVector<ContourTask *> &tasks,
+    QThreadPool *pool )
+{
+    if ( pool == NULL )
+        pool = QThreadPool::globalInstance();
+
+    QSemaphore done;
+
+    for ( int i = 1; i < tasks.size(); i++ )
+    {
+        tasks[i]->done = &done;
+        pool->start( tasks[i] );
+    }
+
+    // the calling thread is working on the first task
+    tasks[0]->execute();
+
+    int numRunning = tasks.size() - 1;
+
+#if QT_VERSION >= 0x050900
+    // tasks, that have not been started yet, are done here
+    for ( int i = 1; i < tasks.size(); i++ )
+    {
+        if ( pool->tryTake( tasks[i] ) )
+        {
+            tasks[i]->execute();
+            numRunning--;
+        }
+    }
+#endif
+
+    done.acquire( numRunning );
+}
+
+#endif
+
+static ContourSegments qwtContourSegments( const ContourGrid &grid,
+    int numRows, uint numThreads, QThreadPool *pool )
+{
+    const int numCellRows = numRows - 1;
+
+#if !defined(QT_NO_QFUTURE)
+    // bands of less rows are not worth the overhead of a thread
+    const int minBandRows = 16;
+    const int numBands = qBound( 1, numCellRows / minBandRows,
+        qwtThreadCount( numThreads ) );
+
+    if ( numBands > 1 )
+    {
+        const int numBandRows = numCellRows / numBands;
+
+        QVector<ContourTask *> tasks;
+        tasks.reserve( numBands );
+
+        for ( int i = 0; i < numBands; i++ )
+        {
+            BandTask *task = new BandTask();
+            task->grid = &grid;
+            task->fromRow = i * numBandRows;
+            task->toRow = ( i < numBands - 1 )
+                ? task->fromRow + numBandRows : numCellRows;
+
+            tasks += task;
+        }
+
+        qwtRunTasks( tasks, pool );
+
+        // concatenating the bands in the order of the rows
+
+        ContourSegments segments =
+            static_cast<BandTask *>( tasks[0] )->segments;
+
+        for ( int i = 1; i < tasks.size(); i++ )
+        {
+            const ContourSegments &band =
+                static_cast<BandTask *>( tasks[i] )->segments;
+
+            for ( int l = 0; l < segments.size(); l++ )
+                segments[l] += band[l];
+        }
+
+        qDeleteAll( tasks );
+        return segments;
+    }
+#else
+    Q_UNUSED( numThreads )
+    Q_UNUSED( pool )
+#endif
+
+    return qwtContourBand( &grid, 0, numCellRows );
+}
+
+static bool qwtInitContourGrid( const QwtRasterData *data,
+    const QRectF &rect, const QSize &raster, const QList<double> &levels,
+    QwtRasterData::ConrecFlags flags, ContourGrid &grid )
+{
+    if ( levels.size() == 0 || !rect.isValid() || !raster.isValid() )
+        return false;
+
+    if ( raster.width() < 2 || raster.height() < 2 )
+        return false;
+
+    const double dx = rect.width() / raster.width();
+
+    grid.data = data;
+
+    grid.xValues.resize( raster.width() );
+    for ( int i = 0; i < raster.width(); i++ )
+        grid.xValues[i] = rect.x() + i * dx;
+
+    grid.y0 = rect.y();
+    grid.dy = rect.height() / raster.height();
+
+    grid.levels = levels.toVector();
+
+    grid.ignoreOnPlane = flags & QwtRasterData::IgnoreAllVerticesOnLevel;
+
+    grid.range = data->interval( Qt::ZAxis );
+    grid.ignoreOutOfRange = false;
+    if ( grid.range.isValid() )
+        grid.ignoreOutOfRange = flags & QwtRasterData::IgnoreOutOfRange;
+
+    return true;
+}
+
 class QwtRasterData::PrivateData
 {
 public:
@@ -238,6 +696,29 @@ void QwtRasterData::discardRaster()
 {
 }
 
+/*!
+  \brief Find the values for a row of positions
+
+  QwtPlotSpectrogram renders its image row by row and calls
+  valueRow() instead of value() for each pixel. The default
+  implementation calls value() for each position, but implementations
+  that can take advantage of knowing the complete row in
+  advance ( f.e. QwtMatrixRasterData ) might reimplement it.
+
+  \param y Y value in plot coordinates, that is the same for all positions
+  \param x Array of X values in plot coordinates
+  \param values Array, where the values are stored
+  \param count Number of positions
+
+  \sa value()
+*/
+void QwtRasterData::valueRow( double y, const double *x,
+    double *values, int count ) const
+{
+    for ( int i = 0; i < count; i++ )
+        values[i] = value( x[i], y );
+}
+
 /*!
    \brief Pixel hint
 
@@ -278,10 +759,12 @@ QRectF QwtRasterData::pixelHint( const QRectF &area ) const
    \param levels List of limits, where to insert contour lines
    \param flags Flags to customize the contouring algorithm
 
-   \return Calculated contour lines
+   \return Calculated contour lines, as pairs of points for each segment
 
    An adaption of CONREC, a simple contouring algorithm.
    http://local.wasp.uwa.edu.au/~pbourke/papers/conrec/
+
+   \sa contourPolylines(), valueRow()
 */
 QwtRasterData::ContourLines QwtRasterData::contourLines(
     const QRectF &rect, const QSize &raster,
@@ -289,141 +772,116 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
 {
     ContourLines contourLines;
 
-    if ( levels.size() == 0 || !rect.isValid() || !raster.isValid() )
+    ContourGrid grid;
+    if ( !qwtInitContourGrid( this, rect, raster, levels, flags, grid ) )
         return contourLines;
 
-    const double dx = rect.width() / raster.width();
-    const double dy = rect.height() / raster.height();
-
-    const bool ignoreOnPlane =
-        flags & QwtRasterData::IgnoreAllVerticesOnLevel;
-
-    const QwtInterval range = interval( Qt::ZAxis );
-    bool ignoreOutOfRange = false;
-    if ( range.isValid() )
-        ignoreOutOfRange = flags & IgnoreOutOfRange;
-
     QwtRasterData *that = const_cast<QwtRasterData *>( this );
     that->initRaster( rect, raster );
 
-    for ( int y = 0; y < raster.height() - 1; y++ )
-    {
-        enum Position
-        {
-            Center,
+    const ContourSegments segments =
+        qwtContourSegments( grid, raster.height(), 1, NULL );
 
-            TopLeft,
-            TopRight,
-            BottomRight,
-            BottomLeft,
+    that->discardRaster();
 
-            NumPositions
-        };
+    for ( int l = 0; l < segments.size(); l++ )
+    {
+        if ( !segments[l].isEmpty() )
+            contourLines.insert( grid.levels[l], segments[l] );
+    }
 
-        QwtPoint3D xy[NumPositions];
+    return contourLines;
+}
 
-        for ( int x = 0; x < raster.width() - 1; x++ )
-        {
-            const QPointF pos( rect.x() + x * dx, rect.y() + y * dy );
+/*!
+   \brief Calculate contour lines joined to polylines
 
-            if ( x == 0 )
-            {
-                xy[TopRight].setX( pos.x() );
-                xy[TopRight].setY( pos.y() );
-                xy[TopRight].setZ(
-                    value( xy[TopRight].x(), xy[TopRight].y() )
-                );
-
-                xy[BottomRight].setX( pos.x() );
-                xy[BottomRight].setY( pos.y() + dy );
-                xy[BottomRight].setZ(
-                    value( xy[BottomRight].x(), xy[BottomRight].y() )
-                );
-            }
+   contourPolylines() runs the same CONREC algorithm as contourLines(),
+   but the raster is split into bands of rows, that are processed
+   in parallel. Each band samples its part of the raster only once
+   using valueRow(). Afterwards the segments of each level are
+   stitched together to polylines, what significantly reduces the
+   number of lines to be painted.
 
-            xy[TopLeft] = xy[TopRight];
-            xy[BottomLeft] = xy[BottomRight];
+   As valueRow() is called from different threads, it has to be
+   thread-safe - like it is required for rendering the image
+   of a QwtPlotSpectrogram with more than one thread.
 
-            xy[TopRight].setX( pos.x() + dx );
-            xy[TopRight].setY( pos.y() );
-            xy[BottomRight].setX( pos.x() + dx );
-            xy[BottomRight].setY( pos.y() + dy );
+   \param rect Bounding rectangle for the contour lines
+   \param raster Number of data pixels of the raster data
+   \param levels List of limits, where to insert contour lines
+   \param flags Flags to customize the contouring algorithm
+   \param numThreads Number of threads to be used, 0 means
+                     the number of cores of the system
+   \param pool Thread pool for the additional threads, NULL means
+               QThreadPool::globalInstance()
 
-            xy[TopRight].setZ(
-                value( xy[TopRight].x(), xy[TopRight].y() )
-            );
-            xy[BottomRight].setZ(
-                value( xy[BottomRight].x(), xy[BottomRight].y() )
-            );
+   \return Calculated contour lines. Closed lines have identical
+           first and last points.
 
-            double zMin = xy[TopLeft].z();
-            double zMax = zMin;
-            double zSum = zMin;
+   \sa contourLines(), QwtPlotSpectrogram::renderContourPolylines()
+*/
+QwtRasterData::ContourPolylines QwtRasterData::contourPolylines(
+    const QRectF &rect, const QSize &raster,
+    const QList<double> &levels, ConrecFlags flags,
+    uint numThreads, QThreadPool *pool ) const
+{
+    ContourPolylines contourPolylines;
 
-            for ( int i = TopRight; i <= BottomLeft; i++ )
-            {
-                const double z = xy[i].z();
+    ContourGrid grid;
+    if ( !qwtInitContourGrid( this, rect, raster, levels, flags, grid ) )
+        return contourPolylines;
 
-                zSum += z;
-                if ( z < zMin )
-                    zMin = z;
-                if ( z > zMax )
-                    zMax = z;
-            }
+    QwtRasterData *that = const_cast<QwtRasterData *>( this );
+    that->initRaster( rect, raster );
 
-            if ( qIsNaN( zSum ) )
-            {
-                // one of the points is NaN
-                continue;
-            }
+    const ContourSegments segments =
+        qwtContourSegments( grid, raster.height(), numThreads, pool );
 
-            if ( ignoreOutOfRange )
-            {
-                if ( !range.contains( zMin ) || !range.contains( zMax ) )
-                    continue;
-            }
+    that->discardRaster();
 
-            if ( zMax < levels[0] ||
-                zMin > levels[levels.size() - 1] )
-            {
-                continue;
-            }
+    QVector< QList<QPolygonF> > polylines( segments.size() );
 
-            xy[Center].setX( pos.x() + 0.5 * dx );
-            xy[Center].setY( pos.y() + 0.5 * dy );
-            xy[Center].setZ( 0.25 * zSum );
+#if !defined(QT_NO_QFUTURE)
+    // the levels can be stitched independently
 
-            const int numLevels = levels.size();
-            for ( int l = 0; l < numLevels; l++ )
-            {
-                const double level = levels[l];
-                if ( level < zMin || level > zMax )
-                    continue;
-                QPolygonF &lines = contourLines[level];
-                const ContourPlane plane( level );
+    const int numTasks = qMin( qwtThreadCount( numThreads ),
+        int( segments.size() ) );
 
-                QPointF line[2];
-                QwtPoint3D vertex[3];
+    if ( numTasks > 1 )
+    {
+        QVector<ContourTask *> tasks;
+        tasks.reserve( numTasks );
 
-                for ( int m = TopLeft; m < NumPositions; m++ )
-                {
-                    vertex[0] = xy[m];
-                    vertex[1] = xy[0];
-                    vertex[2] = xy[m != BottomLeft ? m + 1 : TopLeft];
+        for ( int i = 0; i < numTasks; i++ )
+        {
+            JoinTask *task = new JoinTask();
+            task->segments = &segments;
+            task->polylines = polylines.data();
+            task->firstLevel = i;
+            task->levelStep = numTasks;
 
-                    const bool intersects =
-                        plane.intersect( vertex, line, ignoreOnPlane );
-                    if ( intersects )
-                    {
-                        lines += line[0];
-                        lines += line[1];
-                    }
-                }
-            }
+            tasks += task;
+        }
+
+        qwtRunTasks( tasks, pool );
+        qDeleteAll( tasks );
+    }
+    else
+#endif
+    {
+        for ( int l = 0; l < segments.size(); l++ )
+        {
+            if ( !segments[l].isEmpty() )
+                polylines[l] = qwtJoinSegments( segments[l] );
         }
     }
 
-    that->discardRaster();
+    for ( int l = 0; l < segments.size(); l++ )
+    {
+        if ( !segments[l].isEmpty() )
+            contourPolylines.insert( grid.levels[l], polylines[l] );
+    }
 
-    return contourLines;
+    return contourPolylines;
 }
@@ -17,6 +17,7 @@ class QwtInterval;
 class QPolygonF;
 class QRectF;
 class QSize;
+class QThreadPool;
 template <typename T> class QList;
 template <class Key, class T> class QMap;
 
@@ -45,6 +46,9 @@ public:
     //! Contour lines
     typedef QMap<double, QPolygonF> ContourLines;
 
+    //! Contour lines joined to polylines
+    typedef QMap< double, QList<QPolygonF> > ContourPolylines;
+
     /*!
       \brief Raster data attributes
 
@@ -81,7 +85,14 @@ public:
         IgnoreAllVerticesOnLevel = 0x01,
 
         //! Ignore all values, that are out of range
-        IgnoreOutOfRange = 0x02
+        IgnoreOutOfRange = 0x02,
+
+        /*!
+          Join the segments of the contour lines to polylines.
+          QwtPlotSpectrogram uses contourPolylines() instead of
+          contourLines() then.
+         */
+        JoinPolylines = 0x04
     };
 
     //! Flags to modify the contour algorithm
@@ -111,10 +122,18 @@ public:
     */
     virtual double value( double x, double y ) const = 0;
 
+    virtual void valueRow( double y, const double *x,
+        double *values, int count ) const;
+
     virtual ContourLines contourLines( const QRectF &rect,
         const QSize &raster, const QList<double> &levels,
         ConrecFlags ) const;
 
+    virtual ContourPolylines contourPolylines( const QRectF &rect,
+        const QSize &raster, const QList<double> &levels,
+        ConrecFlags, uint numThreads = 1,
+        QThreadPool *pool = NULL ) const;
+
     class Contour3DPoint;
     class ContourPlane;
 
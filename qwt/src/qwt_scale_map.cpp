@@ -13,6 +13,35 @@
 #include <qrect.h>
 #include <qdebug.h>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+    ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define QWT_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static void qwtTransformLinear( const double *values, double *result,
+    int count, double p1, double ts1, double cnv )
+{
+    int i = 0;
+
+#if QWT_USE_SSE2
+    const __m128d vp1 = _mm_set1_pd( p1 );
+    const __m128d vts1 = _mm_set1_pd( ts1 );
+    const __m128d vcnv = _mm_set1_pd( cnv );
+
+    for ( ; i + 1 < count; i += 2 )
+    {
+        __m128d v = _mm_loadu_pd( values + i );
+        v = _mm_add_pd( vp1, _mm_mul_pd( _mm_sub_pd( v, vts1 ), vcnv ) );
+
+        _mm_storeu_pd( result + i, v );
+    }
+#endif
+
+    for ( ; i < count; i++ )
+        result[i] = p1 + ( values[i] - ts1 ) * cnv;
+}
+
 /*!
   \brief Constructor
 
@@ -140,6 +169,37 @@ void QwtScaleMap::updateFactor()
         d_cnv = ( d_p2 - d_p1 ) / ( ts2 - d_ts1 );
 }
 
+/*!
+  \brief Transform an array of values from scale into
+         paint device coordinates
+
+  The result is the same as calling transform() for each value,
+  but the transformation ( QwtTransform::transformBlock() ) is called
+  only once for all values and the linear part of the mapping is
+  done in a loop using SIMD instructions, when available.
+
+  \param values Values relative to the coordinates of the scale
+  \param result Array for the transformed values. It might be
+                the same array as values.
+  \param count Number of values
+
+  \sa transform()
+*/
+void QwtScaleMap::transformBlock(
+    const double *values, double *result, int count ) const
+{
+    if ( count <= 0 )
+        return;
+
+    if ( d_transform )
+    {
+        d_transform->transformBlock( values, result, count );
+        values = result;
+    }
+
+    qwtTransformLinear( values, result, count, d_p1, d_ts1, d_cnv );
+}
+
 /*!
    Transform a rectangle from scale to paint coordinates
 
@@ -42,6 +42,9 @@ public:
     double transform( double s ) const;
     double invTransform( double p ) const;
 
+    void transformBlock( const double *values,
+        double *result, int count ) const;
+
     double p1() const;
     double p2() const;
 
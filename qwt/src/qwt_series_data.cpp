@@ -96,10 +96,12 @@ QRectF qwtBoundingRectT(
     if ( to < from )
         return boundingRect;
 
+    QwtSampleBlockReader<T> reader( &series, from, to );
+
     int i;
     for ( i = from; i <= to; i++ )
     {
-        const QRectF rect = qwtBoundingRect( series.sample( i ) );
+        const QRectF rect = qwtBoundingRect( reader.next() );
         if ( rect.width() >= 0.0 && rect.height() >= 0.0 )
         {
             boundingRect = rect;
@@ -110,7 +112,7 @@ QRectF qwtBoundingRectT(
 
     for ( ; i <= to; i++ )
     {
-        const QRectF rect = qwtBoundingRect( series.sample( i ) );
+        const QRectF rect = qwtBoundingRect( reader.next() );
         if ( rect.width() >= 0.0 && rect.height() >= 0.0 )
         {
             boundingRect.setLeft( qMin( boundingRect.left(), rect.left() ) );
@@ -245,6 +247,40 @@ QRectF qwtBoundingRect(
     return qwtBoundingRectT<QwtVectorSample>( series, from, to );
 }
 
+/*
+  Update the bounding rectangle, that is cached for the first
+  rectSize samples. Appended samples are added without
+  iterating over the complete series again.
+ */
+template <class T>
+static QRectF qwtCachedBoundingRect( const QwtSeriesData<T> &series,
+    QRectF &rect, size_t &rectSize )
+{
+    const size_t numSamples = series.size();
+
+    if ( rect.width() < 0.0 || rectSize > numSamples )
+    {
+        rect = qwtBoundingRectT<T>( series, 0, -1 );
+    }
+    else if ( rectSize < numSamples )
+    {
+        const QRectF r = qwtBoundingRectT<T>( series,
+            static_cast<int>( rectSize ), static_cast<int>( numSamples ) - 1 );
+
+        if ( r.width() >= 0.0 && r.height() >= 0.0 )
+        {
+            // QRectF::united ignores rectangles with a size of 0
+            rect.setLeft( qMin( rect.left(), r.left() ) );
+            rect.setRight( qMax( rect.right(), r.right() ) );
+            rect.setTop( qMin( rect.top(), r.top() ) );
+            rect.setBottom( qMax( rect.bottom(), r.bottom() ) );
+        }
+    }
+
+    rectSize = numSamples;
+    return rect;
+}
+
 /*!
    Constructor
    \param samples Samples
@@ -259,16 +295,14 @@ QwtPointSeriesData::QwtPointSeriesData(
   \brief Calculate the bounding rectangle
 
   The bounding rectangle is calculated once by iterating over all
-  points and is stored for all following requests.
+  points and is stored for all following requests. Appended
+  samples are added to the stored rectangle.
 
   \return Bounding rectangle
 */
 QRectF QwtPointSeriesData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
 
 /*!
@@ -285,16 +319,14 @@ QwtPoint3DSeriesData::QwtPoint3DSeriesData(
   \brief Calculate the bounding rectangle
 
   The bounding rectangle is calculated once by iterating over all
-  points and is stored for all following requests.
+  points and is stored for all following requests. Appended
+  samples are added to the stored rectangle.
 
   \return Bounding rectangle
 */
 QRectF QwtPoint3DSeriesData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
 
 /*!
@@ -311,16 +343,14 @@ QwtIntervalSeriesData::QwtIntervalSeriesData(
   \brief Calculate the bounding rectangle
 
   The bounding rectangle is calculated once by iterating over all
-  points and is stored for all following requests.
+  points and is stored for all following requests. Appended
+  samples are added to the stored rectangle.
 
   \return Bounding rectangle
 */
 QRectF QwtIntervalSeriesData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
 
 /*!
@@ -338,16 +368,14 @@ QwtVectorFieldData::QwtVectorFieldData(
   \brief Calculate the bounding rectangle
 
   The bounding rectangle is calculated once by iterating over all
-  points and is stored for all following requests.
+  points and is stored for all following requests. Appended
+  samples are added to the stored rectangle.
 
   \return Bounding rectangle
 */
 QRectF QwtVectorFieldData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
 
 double QwtVectorFieldData::maxMagnitude() const
@@ -379,10 +407,7 @@ QwtSetSeriesData::QwtSetSeriesData(
 
 QRectF QwtSetSeriesData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
 
 /*!
@@ -399,14 +424,12 @@ QwtTradingChartData::QwtTradingChartData(
   \brief Calculate the bounding rectangle
 
   The bounding rectangle is calculated once by iterating over all
-  points and is stored for all following requests.
+  points and is stored for all following requests. Appended
+  samples are added to the stored rectangle.
 
   \return Bounding rectangle
 */
 QRectF QwtTradingChartData::boundingRect() const
 {
-    if ( d_boundingRect.width() < 0.0 )
-        d_boundingRect = qwtBoundingRect( *this );
-
-    return d_boundingRect;
+    return qwtCachedBoundingRect( *this, d_boundingRect, d_boundingRectSize );
 }
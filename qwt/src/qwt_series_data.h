@@ -43,7 +43,16 @@ class QwtPointPolar;
      but often it is possible to implement a more efficient algorithm
      depending on the characteristics of the series.
      The member d_boundingRect is intended for caching the calculated rectangle.
+     When samples are modified invalidateBoundingRect() has to be called.
 
+   Optionally a subclass might implement:
+
+   - sampleBlock()\n
+     Copies a block of consecutive samples into a buffer. The default
+     implementation calls sample() for each of them. When the samples
+     are stored in arrays it is recommended to reimplement it, as
+     the loops iterating over large series ( f.e. QwtPointMapper )
+     read the samples block by block.
 */
 template <typename T>
 class QwtSeriesData
@@ -101,17 +110,29 @@ public:
     */
     virtual void setRectOfInterest( const QRectF &rect );
 
+    virtual void sampleBlock( size_t from, size_t count, T *samples ) const;
+
+    void invalidateBoundingRect( size_t from = 0 );
+
 protected:
     //! Can be used to cache a calculated bounding rectangle
     mutable QRectF d_boundingRect;
 
+    /*!
+      Number of leading samples, that are included in d_boundingRect.
+      Samples behind have been appended later and can be added
+      to the cached rectangle without iterating over the complete series.
+     */
+    mutable size_t d_boundingRectSize;
+
 private:
     QwtSeriesData<T> &operator=( const QwtSeriesData<T> & );
 };
 
 template <typename T>
 QwtSeriesData<T>::QwtSeriesData():
-    d_boundingRect( 0.0, 0.0, -1.0, -1.0 )
+    d_boundingRect( 0.0, 0.0, -1.0, -1.0 ),
+    d_boundingRectSize( 0 )
 {
 }
 
@@ -125,6 +146,49 @@ void QwtSeriesData<T>::setRectOfInterest( const QRectF & )
 {
 }
 
+/*!
+  \brief Invalidate the cached bounding rectangle
+
+  Samples, that are appended, are added to the cached bounding rectangle
+  by the implementations of Qwt without rescanning the series. But
+  when samples in the range of the cached rectangle are modified, the
+  rectangle has to be calculated from scratch.
+
+  \param from Index of the first modified sample, all samples
+              before are unchanged. 0 means, that the complete
+              series has been changed.
+*/
+template <typename T>
+void QwtSeriesData<T>::invalidateBoundingRect( size_t from )
+{
+    if ( from == 0 || from < d_boundingRectSize )
+    {
+        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+        d_boundingRectSize = 0;
+    }
+}
+
+/*!
+  \brief Copy a block of consecutive samples
+
+  The default implementation calls sample() for each index.
+  Reimplementing sampleBlock() avoids the virtual call for each sample,
+  what makes a difference for loops iterating over large series.
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+
+  \sa QwtSampleBlockReader
+*/
+template <typename T>
+void QwtSeriesData<T>::sampleBlock(
+    size_t from, size_t count, T *samples ) const
+{
+    for ( size_t i = 0; i < count; i++ )
+        samples[i] = sample( from + i );
+}
+
 /*!
   \brief Template class for data, that is organized as QVector
 
@@ -150,6 +214,16 @@ public:
     */
     void setSamples( const QVector<T> &samples );
 
+    /*!
+      Append samples
+
+      The cached bounding rectangle is extended by the
+      appended samples, when it is requested the next time.
+
+      \param samples Array of samples
+    */
+    void appendSamples( const QVector<T> &samples );
+
     //! \return Array of samples
     const QVector<T> samples() const;
 
@@ -164,6 +238,9 @@ public:
     */
     virtual T sample( size_t index ) const QWT_OVERRIDE;
 
+    virtual void sampleBlock( size_t from,
+        size_t count, T *samples ) const QWT_OVERRIDE;
+
 protected:
     //! Vector of samples
     QVector<T> d_samples;
@@ -183,10 +260,16 @@ QwtArraySeriesData<T>::QwtArraySeriesData( const QVector<T> &samples ):
 template <typename T>
 void QwtArraySeriesData<T>::setSamples( const QVector<T> &samples )
 {
-    QwtSeriesData<T>::d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    QwtSeriesData<T>::invalidateBoundingRect();
     d_samples = samples;
 }
 
+template <typename T>
+void QwtArraySeriesData<T>::appendSamples( const QVector<T> &samples )
+{
+    d_samples += samples;
+}
+
 template <typename T>
 const QVector<T> QwtArraySeriesData<T>::samples() const
 {
@@ -205,6 +288,23 @@ T QwtArraySeriesData<T>::sample( size_t i ) const
     return d_samples[ static_cast<int>( i ) ];
 }
 
+/*!
+  Copy a block of consecutive samples
+
+  \param from Index of the first sample
+  \param count Number of samples
+  \param samples Buffer, that has to be large enough for count samples
+*/
+template <typename T>
+void QwtArraySeriesData<T>::sampleBlock(
+    size_t from, size_t count, T *samples ) const
+{
+    const T *values = d_samples.constData() + from;
+
+    for ( size_t i = 0; i < count; i++ )
+        samples[i] = values[i];
+}
+
 //! Interface for iterating over an array of points
 class QWT_EXPORT QwtPointSeriesData: public QwtArraySeriesData<QPointF>
 {
@@ -291,6 +391,80 @@ QWT_EXPORT QRectF qwtBoundingRect(
 QWT_EXPORT QRectF qwtBoundingRect(
     const QwtSeriesData<QwtVectorSample> &, int from = 0, int to = -1 );
 
+/*!
+  \brief Sequential reading of samples block by block
+
+  QwtSampleBlockReader fetches the samples of an interval
+  with QwtSeriesData<T>::sampleBlock() into a small buffer, so
+  that there is only one virtual call for each block
+  instead of one for each sample.
+
+  \par Example
+  \code
+    QwtSampleBlockReader<QPointF> reader( series, from, to );
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF &sample = reader.next();
+        ...
+    }
+  \endcode
+*/
+template <typename T>
+class QwtSampleBlockReader
+{
+public:
+    //! Size of the buffer
+    enum { BlockSize = 128 };
+
+    /*!
+      Constructor
+
+      \param series Series
+      \param from Index of the first sample
+      \param to Index of the last sample
+     */
+    QwtSampleBlockReader( const QwtSeriesData<T> *series, int from, int to ):
+        d_series( series ),
+        d_index( from ),
+        d_to( to ),
+        d_pos( 0 ),
+        d_count( 0 )
+    {
+    }
+
+    /*!
+      \return Next sample
+      \warning Reading beyond the last sample is undefined
+     */
+    inline const T &next()
+    {
+        if ( d_pos == d_count )
+            fetch();
+
+        return d_buffer[ d_pos++ ];
+    }
+
+private:
+    void fetch()
+    {
+        d_count = qMin( static_cast<int>( BlockSize ), d_to - d_index + 1 );
+        d_series->sampleBlock( d_index, d_count, d_buffer );
+
+        d_index += d_count;
+        d_pos = 0;
+    }
+
+    const QwtSeriesData<T> *d_series;
+
+    int d_index;
+    const int d_to;
+
+    int d_pos;
+    int d_count;
+
+    T d_buffer[ BlockSize ];
+};
+
 /*!
     Binary search for a sorted series of samples
 
@@ -28,6 +28,9 @@ public:
     virtual ~QwtAbstractSeriesStore() {}
 
 protected:
+    //! dataAboutToChange() indicates, that the series is going to be replaced
+    virtual void dataAboutToChange() {}
+
 #ifndef QWT_PYTHON_WRAPPER
     //! dataChanged() indicates, that the series has been changed.
     virtual void dataChanged() = 0;
@@ -165,6 +168,8 @@ void QwtSeriesStore<T>::setData( QwtSeriesData<T> *series )
 {
     if ( d_series != series )
     {
+        dataAboutToChange();
+
         delete d_series;
         d_series = series;
         dataChanged();
@@ -199,6 +204,8 @@ void QwtSeriesStore<T>::setRectOfInterest( const QRectF &rect )
 template <typename T>
 QwtSeriesData<T>* QwtSeriesStore<T>::swapData( QwtSeriesData<T> *series )
 {
+    dataAboutToChange();
+
     QwtSeriesData<T> * swappedSeries = d_series;
     d_series = series;
 
@@ -10,14 +10,68 @@
 #include "qwt_spline_curve_fitter.h"
 #include "qwt_spline_local.h"
 #include "qwt_spline_parametrization.h"
+#include "qwt_series_data.h"
+#include "qwt_scale_map.h"
+#include "qwt_transform.h"
 
 #include <qpolygon.h>
 #include <qpainterpath.h>
+#include <qvector.h>
+#include <qline.h>
+
+static inline bool qwtIsLinear( const QwtScaleMap &map )
+{
+    const QwtTransform *transform = map.transformation();
+    return ( transform == NULL )
+        || ( dynamic_cast< const QwtNullTransform * >( transform ) != NULL );
+}
+
+static inline bool qwtIsAffineInvariant( const QwtSplineInterpolating *spline )
+{
+    if ( spline == NULL )
+        return false;
+
+    /*
+        The parameters of other parametrizations depend on the distances
+        between the points, that are not preserved when scaling x and y
+        differently
+     */
+    const int type = spline->parametrization()->type();
+    return ( type == QwtSplineParametrization::ParameterUniform )
+        || ( type == QwtSplineParametrization::ParameterX );
+}
+
+static inline QPointF qwtMapped( const QwtScaleMap &xMap,
+    const QwtScaleMap &yMap, const QPointF &pos )
+{
+    return QPointF( xMap.transform( pos.x() ), yMap.transform( pos.y() ) );
+}
+
+class QwtSplineCurveFitter::PrivateData
+{
+public:
+    PrivateData():
+        isCacheEnabled( false ),
+        series( NULL )
+    {
+    }
+
+    bool isCacheEnabled;
+
+    // the series, that has been used for the cache
+    const QwtSeriesData<QPointF> *series;
+
+    // points and Bezier control lines in plot coordinates
+    QPolygonF points;
+    QVector<QLineF> controlLines;
+};
 
 //! Constructor
 QwtSplineCurveFitter::QwtSplineCurveFitter():
     QwtCurveFitter( QwtCurveFitter::Path )
 {
+    d_data = new PrivateData;
+
     d_spline = new QwtSplineLocal( QwtSplineLocal::Cardinal );
     d_spline->setParametrization( QwtSplineParametrization::ParameterUniform );
 }
@@ -26,6 +80,7 @@ QwtSplineCurveFitter::QwtSplineCurveFitter():
 QwtSplineCurveFitter::~QwtSplineCurveFitter()
 {
     delete d_spline;
+    delete d_data;
 }
 
 /*!
@@ -44,6 +99,8 @@ void QwtSplineCurveFitter::setSpline( QwtSpline *spline )
 
     delete d_spline;
     d_spline = spline;
+
+    invalidateCache();
 }
 
 /*!
@@ -100,3 +157,155 @@ QPainterPath QwtSplineCurveFitter::fitCurvePath( const QPolygonF &points ) const
 
     return path;
 }
+
+/*!
+  \brief En/Disable the cache for mappedCurvePath()
+
+  When the cache is enabled the Bezier control points are calculated
+  in plot coordinates, what is only the same as fitting in paint device
+  coordinates for affine invariant splines like the default setting.
+  For parametrizations other than QwtSplineParametrization::ParameterX
+  and QwtSplineParametrization::ParameterUniform the cache is not used.
+
+  The cached spline is rebuilt, when the series or its size
+  has been changed. Samples, that are modified in place, need to
+  be followed by invalidateCache().
+
+  \param on On/Off
+  \sa isCacheEnabled(), mappedCurvePath(), invalidateCache()
+*/
+void QwtSplineCurveFitter::setCacheEnabled( bool on )
+{
+    if ( on != d_data->isCacheEnabled )
+    {
+        d_data->isCacheEnabled = on;
+        invalidateCache();
+    }
+}
+
+/*!
+  \return True, when the cache is enabled
+  \sa setCacheEnabled()
+*/
+bool QwtSplineCurveFitter::isCacheEnabled() const
+{
+    return d_data->isCacheEnabled;
+}
+
+/*!
+  \brief Invalidate the cache
+
+  The cache needs to be invalidated, when the samples of the series or
+  parameters of the spline have been changed. QwtPlotCurve does this for
+  its fitter, whenever its data has been changed.
+
+  \sa setCacheEnabled(), mappedCurvePath()
+*/
+void QwtSplineCurveFitter::invalidateCache()
+{
+    d_data->series = NULL;
+    d_data->points.clear();
+    d_data->controlLines.clear();
+}
+
+/*!
+  \brief Fit a curve and map it to paint device coordinates
+
+  When the cache is enabled and the spline is a QwtSplineInterpolating
+  with an uniform or x parametrization, the control lines of the spline
+  are calculated only once in plot coordinates. Then mapping the Bezier
+  curves of the visible segments is all that needs to be done
+  for painting. For non linear scales
+  the samples are mapped before fitting them like in fitCurvePath().
+
+  \param series Series of samples
+  \param xMap Maps x-values into paint device coordinates
+  \param yMap Maps y-values into paint device coordinates
+  \param clipRect Segments outside of this rectangle ( in paint device
+                  coordinates ) are not included
+
+  \return Curve path in paint device coordinates
+  \sa setCacheEnabled(), invalidateCache()
+*/
+QPainterPath QwtSplineCurveFitter::mappedCurvePath(
+    const QwtSeriesData<QPointF> *series,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &clipRect ) const
+{
+    if ( series == NULL )
+        return QPainterPath();
+
+    const QwtSplineInterpolating *spline =
+        dynamic_cast< const QwtSplineInterpolating * >( d_spline );
+
+    const int numSamples = static_cast<int>( series->size() );
+
+    if ( !( d_data->isCacheEnabled && qwtIsAffineInvariant( spline )
+        && numSamples > 2 && qwtIsLinear( xMap ) && qwtIsLinear( yMap ) ) )
+    {
+        QPolygonF points( numSamples );
+        for ( int i = 0; i < numSamples; i++ )
+            points[i] = qwtMapped( xMap, yMap, series->sample( i ) );
+
+        return fitCurvePath( points );
+    }
+
+    if ( d_data->series != series || d_data->points.size() != numSamples )
+    {
+        d_data->points.resize( numSamples );
+
+        QwtSampleBlockReader<QPointF> reader( series, 0, numSamples - 1 );
+
+        QPointF *cachedPoints = d_data->points.data();
+        for ( int i = 0; i < numSamples; i++ )
+            cachedPoints[i] = reader.next();
+
+        d_data->controlLines = spline->bezierControlLines( d_data->points );
+        d_data->series = series;
+    }
+
+    const QPolygonF &points = d_data->points;
+    const QVector<QLineF> &controlLines = d_data->controlLines;
+
+    int numSegments = numSamples - 1;
+    if ( spline->boundaryType() == QwtSpline::ClosedPolygon )
+        numSegments = numSamples;
+
+    numSegments = qMin( numSegments, controlLines.size() );
+
+    const QRectF area = QwtScaleMap::invTransform( xMap, yMap, clipRect );
+
+    QPainterPath path;
+
+    bool isConnected = false;
+    for ( int i = 0; i < numSegments; i++ )
+    {
+        const QPointF &p1 = points[i];
+        const QPointF &p2 = points[ ( i + 1 ) % numSamples ];
+        const QLineF &l = controlLines[i];
+
+        // a Bezier curve is inside the bounding rectangle of its control points
+
+        const double xMin = qMin( qMin( p1.x(), p2.x() ), qMin( l.x1(), l.x2() ) );
+        const double xMax = qMax( qMax( p1.x(), p2.x() ), qMax( l.x1(), l.x2() ) );
+        const double yMin = qMin( qMin( p1.y(), p2.y() ), qMin( l.y1(), l.y2() ) );
+        const double yMax = qMax( qMax( p1.y(), p2.y() ), qMax( l.y1(), l.y2() ) );
+
+        if ( xMax < area.left() || xMin > area.right()
+            || yMax < area.top() || yMin > area.bottom() )
+        {
+            isConnected = false;
+            continue;
+        }
+
+        if ( !isConnected )
+            path.moveTo( qwtMapped( xMap, yMap, p1 ) );
+
+        path.cubicTo( qwtMapped( xMap, yMap, l.p1() ),
+            qwtMapped( xMap, yMap, l.p2() ), qwtMapped( xMap, yMap, p2 ) );
+
+        isConnected = true;
+    }
+
+    return path;
+}
@@ -13,6 +13,10 @@
 #include "qwt_curve_fitter.h"
 
 class QwtSpline;
+class QwtScaleMap;
+class QRectF;
+class QPointF;
+template <typename T> class QwtSeriesData;
 
 /*!
   \brief A curve fitter using a spline interpolation
@@ -20,6 +24,13 @@ class QwtSpline;
   The default setting for the spline is a cardinal spline with
   uniform parametrization.
 
+  As the result of fitCurve() and fitCurvePath() is in the same
+  coordinates as the points, the spline has to be solved again for
+  every repaint. When the cache is enabled, mappedCurvePath() solves
+  the spline once in plot coordinates and maps the Bezier control points
+  of the visible segments only - what is possible as linear scales map
+  a Bezier curve to a Bezier curve.
+
   \sa QwtSpline, QwtSplineLocal
 */
 class QWT_EXPORT QwtSplineCurveFitter: public QwtCurveFitter
@@ -36,8 +47,20 @@ public:
     virtual QPolygonF fitCurve( const QPolygonF & ) const QWT_OVERRIDE;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const QWT_OVERRIDE;
 
+    void setCacheEnabled( bool );
+    bool isCacheEnabled() const;
+
+    void invalidateCache();
+
+    QPainterPath mappedCurvePath( const QwtSeriesData<QPointF> *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &clipRect ) const;
+
 private:
     QwtSpline *d_spline;
+
+    class PrivateData;
+    PrivateData *d_data;
 };
 
 #endif
@@ -15,11 +15,21 @@
 #include <qpainter.h>
 #include <qpainterpath.h>
 #include <qpixmap.h>
+#include <qimage.h>
+#include <qvector.h>
 #include <qpaintengine.h>
 #ifndef QWT_NO_SVG
 #include <qsvgrenderer.h>
 #endif
 
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#if !defined(QT_NO_QFUTURE)
+#define QWT_USE_THREADS 1
+#endif
+
 namespace QwtTriangle
 {
     enum Type
@@ -66,6 +76,140 @@ static inline QRectF qwtScaledBoundingRect(
     return graphic.scaledBoundingRect( sx, sy );
 }
 
+namespace
+{
+    enum
+    {
+        // number of sub-pixel positions of a sprite in each direction
+        SpritePhases = 4
+    };
+
+    class SpriteCommand
+    {
+    public:
+        // SpritePhases * SpritePhases images of the symbol
+        const QImage *sprites;
+
+        // position of the sprites relative to the symbol position
+        QPoint offset;
+
+        const QPointF *points;
+        int numPoints;
+
+        // optional colors for each point
+        const QRgb *colors;
+
+        QRgb *bits;
+        int width;
+        int height;
+    };
+}
+
+static inline QRgb qwtScalePixel( QRgb rgb, uint alpha )
+{
+    // multiplying all channels by alpha / 255
+
+    uint rb = ( rgb & 0x00ff00ff ) * alpha;
+    rb = ( rb + ( ( rb >> 8 ) & 0x00ff00ff ) + 0x00800080 ) >> 8;
+
+    uint ag = ( ( rgb >> 8 ) & 0x00ff00ff ) * alpha;
+    ag = ag + ( ( ag >> 8 ) & 0x00ff00ff ) + 0x00800080;
+
+    return ( rb & 0x00ff00ff ) | ( ag & 0xff00ff00 );
+}
+
+static inline QRgb qwtBlendPixel( QRgb src, QRgb dst )
+{
+    // source over for premultiplied colors
+
+    const uint alpha = qAlpha( src );
+    if ( alpha == 255 )
+        return src;
+
+    if ( alpha == 0 )
+        return dst;
+
+    return src + qwtScalePixel( dst, 255 - alpha );
+}
+
+static void qwtBlitSprites( const SpriteCommand &command,
+    int fromRow, int toRow )
+{
+    const int w = command.sprites[0].width();
+    const int h = command.sprites[0].height();
+
+    for ( int i = 0; i < command.numPoints; i++ )
+    {
+        const QPointF &pos = command.points[i];
+
+        // also excluding NaN values
+        if ( !( pos.x() > -w && pos.x() < command.width + w
+            && pos.y() > fromRow - h && pos.y() < toRow + h ) )
+        {
+            continue;
+        }
+
+        // the position in units of a sprite phase
+        const double x = std::floor( pos.x() * SpritePhases + 0.5 );
+        const double y = std::floor( pos.y() * SpritePhases + 0.5 );
+
+        const int ix = qwtFloor( x / SpritePhases );
+        const int iy = qwtFloor( y / SpritePhases );
+
+        const int phase = static_cast<int>( y - iy * SpritePhases ) * SpritePhases
+            + static_cast<int>( x - ix * SpritePhases );
+
+        const QImage &sprite = command.sprites[ phase ];
+
+        const int left = ix + command.offset.x();
+        const int top = iy + command.offset.y();
+
+        const int x1 = qMax( left, 0 );
+        const int x2 = qMin( left + w, command.width );
+        const int y1 = qMax( top, fromRow );
+        const int y2 = qMin( top + h, toRow );
+
+        if ( command.colors )
+        {
+            // the coverage of the sprite painted in the color of the point
+
+            const QRgb c = command.colors[i];
+            const QRgb color = qwtScalePixel( c | 0xff000000, qAlpha( c ) );
+
+            for ( int row = y1; row < y2; row++ )
+            {
+                const QRgb *src = reinterpret_cast<const QRgb *>(
+                    sprite.constScanLine( row - top ) ) + ( x1 - left );
+
+                QRgb *dst = command.bits + row * command.width + x1;
+
+                for ( int col = x1; col < x2; col++ )
+                {
+                    const QRgb rgb = qwtScalePixel( color, qAlpha( *src++ ) );
+                    *dst = qwtBlendPixel( rgb, *dst );
+                    dst++;
+                }
+            }
+        }
+        else
+        {
+            for ( int row = y1; row < y2; row++ )
+            {
+                const QRgb *src = reinterpret_cast<const QRgb *>(
+                    sprite.constScanLine( row - top ) ) + ( x1 - left );
+
+                QRgb *dst = command.bits + row * command.width + x1;
+
+                for ( int col = x1; col < x2; col++ )
+                {
+                    *dst = qwtBlendPixel( *src++, *dst );
+                    dst++;
+                }
+            }
+        }
+    }
+}
+
 static inline void qwtDrawPixmapSymbols( QPainter *painter,
     const QPointF *points, int numPoints, const QwtSymbol &symbol )
 {
@@ -830,6 +974,10 @@ public:
         QwtSymbol::CachePolicy policy;
         QPixmap pixmap;
 
+        QVector<QImage> sprites;
+        QPoint spriteOffset;
+        QPainter::RenderHints spriteHints;
+
     } cache;
 };
 
@@ -1422,6 +1570,153 @@ void QwtSymbol::drawSymbols( QPainter *painter,
     }
 }
 
+/*!
+  \brief Render an array of symbols into an image
+
+  Instead of painting each symbol with QPainter, the symbols are
+  copied from an atlas of prerendered images and blended into the
+  pixels of the image. For each symbol the image of the closest of 4x4
+  sub-pixel offsets is chosen, so that the positions are not rounded
+  to integers.
+
+  The image is divided into bands of rows, that are processed in
+  parallel. As each thread paints the symbols in the order of the
+  points, the result does not depend on the number of threads.
+
+  This is an optimization for scatter plots with a huge number of symbols,
+  where the overhead of painting each symbol with QPainter dominates.
+
+  \param image Image. If it doesn't have the format
+               QImage::Format_ARGB32_Premultiplied it gets converted.
+  \param points Array of points in image coordinates
+  \param numPoints Number of points
+  \param hints Render hints for the images of the atlas
+  \param numThreads Number of threads, 0 means the number of cores
+                    of the system
+
+  \sa invalidateCache(), QwtPlotCurve::ImageBuffer
+*/
+void QwtSymbol::drawSymbols( QImage *image,
+    const QPointF *points, int numPoints,
+    QPainter::RenderHints hints, uint numThreads ) const
+{
+    drawSymbols( image, points, NULL, numPoints, hints, numThreads );
+}
+
+/*!
+  \brief Render an array of symbols with individual colors into an image
+
+  Like drawSymbols( QImage *, const QPointF *, int, QPainter::RenderHints,
+  uint ) const, but each symbol is painted in the color of its point.
+  Only the coverage of the symbol is taken from the atlas, so that the
+  pen and the brush of the symbol get the same color.
+
+  \param image Image. If it doesn't have the format
+               QImage::Format_ARGB32_Premultiplied it gets converted.
+  \param points Array of points in image coordinates
+  \param colors Array of colors for each point, when NULL the colors
+                of the symbol are used
+  \param numPoints Number of points
+  \param hints Render hints for the images of the atlas
+  \param numThreads Number of threads, 0 means the number of cores
+                    of the system
+
+  \sa invalidateCache(), QwtPlotCurve::ImageBuffer
+*/
+void QwtSymbol::drawSymbols( QImage *image,
+    const QPointF *points, const QRgb *colors, int numPoints,
+    QPainter::RenderHints hints, uint numThreads ) const
+{
+    if ( image == NULL || image->isNull() || numPoints <= 0 )
+        return;
+
+    if ( d_data->style == QwtSymbol::NoSymbol )
+        return;
+
+    if ( image->format() != QImage::Format_ARGB32_Premultiplied )
+        *image = image->convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+    QVector<QImage> &sprites = d_data->cache.sprites;
+    if ( hints != d_data->cache.spriteHints )
+        sprites.clear();
+
+    if ( sprites.isEmpty() )
+    {
+        const QRect br = boundingRect();
+
+        // one extra pixel for the sub-pixel offsets
+        const QSize size( br.width() + 1, br.height() + 1 );
+
+        for ( int i = 0; i < SpritePhases * SpritePhases; i++ )
+        {
+            QImage sprite( size, QImage::Format_ARGB32_Premultiplied );
+            sprite.fill( 0 );
+
+            const double dx = double( i % SpritePhases ) / SpritePhases;
+            const double dy = double( i / SpritePhases ) / SpritePhases;
+
+            QPainter p( &sprite );
+            p.setRenderHints( hints );
+            p.translate( -br.left() + dx, -br.top() + dy );
+
+            const QPointF pos( 0.0, 0.0 );
+            renderSymbols( &p, &pos, 1 );
+            p.end();
+
+            sprites += sprite;
+        }
+
+        d_data->cache.spriteOffset = br.topLeft();
+        d_data->cache.spriteHints = hints;
+    }
+
+    SpriteCommand command;
+    command.sprites = sprites.constData();
+    command.offset = d_data->cache.spriteOffset;
+    command.points = points;
+    command.numPoints = numPoints;
+    command.colors = colors;
+    command.bits = reinterpret_cast<QRgb *>( image->bits() );
+    command.width = image->width();
+    command.height = image->height();
+
+#if QWT_USE_THREADS
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+
+    // each thread checks all points, what is not worth it for a few
+    const int minPoints = 10000;
+    if ( numThreads <= 0 || numPoints < minPoints )
+        numThreads = 1;
+
+    numThreads = qMin( numThreads, uint( command.height ) );
+
+    const int numRows = command.height / numThreads;
+
+    QList< QFuture<void> > futures;
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        const int fromRow = i * numRows;
+
+        if ( i == numThreads - 1 )
+        {
+            qwtBlitSprites( command, fromRow, command.height );
+        }
+        else
+        {
+            futures += QtConcurrent::run( &qwtBlitSprites,
+                command, fromRow, fromRow + numRows );
+        }
+    }
+
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    Q_UNUSED( numThreads )
+    qwtBlitSprites( command, 0, command.height );
+#endif
+}
+
 /*!
   \brief Draw the symbol into a rectangle
 
@@ -1774,6 +2069,8 @@ void QwtSymbol::invalidateCache()
 {
     if ( !d_data->cache.pixmap.isNull() )
         d_data->cache.pixmap = QPixmap();
+
+    d_data->cache.sprites.clear();
 }
 
 /*!
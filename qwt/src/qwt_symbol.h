@@ -15,6 +15,7 @@
 #include <qpolygon.h>
 #include <qpen.h>
 #include <qbrush.h>
+#include <qpainter.h>
 
 class QPainter;
 class QSize;
@@ -24,6 +25,7 @@ class QColor;
 class QPointF;
 class QPainterPath;
 class QPixmap;
+class QImage;
 class QByteArray;
 class QwtGraphic;
 
@@ -215,6 +217,15 @@ public:
     void drawSymbols( QPainter *,
         const QPointF *, int numPoints ) const;
 
+    void drawSymbols( QImage *, const QPointF *, int numPoints,
+        QPainter::RenderHints = QPainter::Antialiasing,
+        uint numThreads = 1 ) const;
+
+    void drawSymbols( QImage *, const QPointF *,
+        const QRgb *colors, int numPoints,
+        QPainter::RenderHints = QPainter::Antialiasing,
+        uint numThreads = 1 ) const;
+
     virtual QRect boundingRect() const;
     void invalidateCache();
 
@@ -35,6 +35,25 @@ double QwtTransform::bounded( double value ) const
     return value;
 }
 
+/*!
+  \brief Transform an array of values
+
+  The default implementation calls transform() for each value.
+  Transformations, that can be calculated without the overhead of
+  a virtual call for each value, should reimplement it.
+
+  \param values Values to be transformed
+  \param result Array for the transformed values. It might
+                be the same array as values.
+  \param count Number of values
+ */
+void QwtTransform::transformBlock(
+    const double *values, double *result, int count ) const
+{
+    for ( int i = 0; i < count; i++ )
+        result[i] = transform( values[i] );
+}
+
 //! Constructor
 QwtNullTransform::QwtNullTransform():
     QwtTransform()
@@ -64,6 +83,21 @@ double QwtNullTransform::invTransform( double value ) const
     return value;
 }
 
+/*!
+  \param values Values to be transformed
+  \param result Array for the unmodified values
+  \param count Number of values
+ */
+void QwtNullTransform::transformBlock(
+    const double *values, double *result, int count ) const
+{
+    if ( result != values )
+    {
+        for ( int i = 0; i < count; i++ )
+            result[i] = values[i];
+    }
+}
+
 //! \return Clone of the transformation
 QwtTransform *QwtNullTransform::copy() const
 {
@@ -99,6 +133,18 @@ double QwtLogTransform::invTransform( double value ) const
     return std::exp( value );
 }
 
+/*!
+  \param values Values to be transformed
+  \param result Array for log( value )
+  \param count Number of values
+ */
+void QwtLogTransform::transformBlock(
+    const double *values, double *result, int count ) const
+{
+    for ( int i = 0; i < count; i++ )
+        result[i] = std::log( values[i] );
+}
+
 /*!
   \param value Value to be bounded
   \return qBound( LogMin, value, LogMax )
@@ -64,6 +64,9 @@ public:
      */
     virtual double invTransform( double value ) const = 0;
 
+    virtual void transformBlock( const double *values,
+        double *result, int count ) const;
+
     //! Virtualized copy operation
     virtual QwtTransform *copy() const = 0;
 
@@ -86,6 +89,9 @@ public:
     virtual double transform( double value ) const QWT_OVERRIDE;
     virtual double invTransform( double value ) const QWT_OVERRIDE;
 
+    virtual void transformBlock( const double *values,
+        double *result, int count ) const QWT_OVERRIDE;
+
     virtual QwtTransform *copy() const QWT_OVERRIDE;
 };
 /*!
@@ -106,6 +112,9 @@ public:
     virtual double transform( double value ) const QWT_OVERRIDE;
     virtual double invTransform( double value ) const QWT_OVERRIDE;
 
+    virtual void transformBlock( const double *values,
+        double *result, int count ) const QWT_OVERRIDE;
+
     virtual double bounded( double value ) const QWT_OVERRIDE;
 
     virtual QwtTransform *copy() const QWT_OVERRIDE;
@@ -14,31 +14,290 @@
 #include <qpolygon.h>
 #include <qstack.h>
 #include <qvector.h>
+#include <qlist.h>
+
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#if !defined(QT_NO_QFUTURE)
+#define QWT_USE_THREADS 1
+#endif
+
+namespace
+{
+    class Line
+    {
+    public:
+        Line( int i1 = 0, int i2 = 0 ):
+            from( i1 ),
+            to( i2 )
+        {
+        }
+
+        int from;
+        int to;
+    };
+}
+
+static inline int qwtFarthestPoint( const QPointF *p,
+    const Line &line, double &maxDistSqr )
+{
+    // initialize line segment
+    const double vecX = p[line.to].x() - p[line.from].x();
+    const double vecY = p[line.to].y() - p[line.from].y();
+
+    const double vecLength = std::sqrt( vecX * vecX + vecY * vecY );
+
+    const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
+    const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+
+    maxDistSqr = 0.0;
+    int nVertexIndexMaxDistance = line.from + 1;
+    for ( int i = line.from + 1; i < line.to; i++ )
+    {
+        //compare to anchor
+        const double fromVecX = p[i].x() - p[line.from].x();
+        const double fromVecY = p[i].y() - p[line.from].y();
+
+        double distToSegmentSqr;
+        if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+        {
+            distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+        }
+        else
+        {
+            const double toVecX = p[i].x() - p[line.to].x();
+            const double toVecY = p[i].y() - p[line.to].y();
+            const double toVecLength = toVecX * toVecX + toVecY * toVecY;
+
+            const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
+            if ( s < 0.0 )
+            {
+                distToSegmentSqr = toVecLength;
+            }
+            else
+            {
+                distToSegmentSqr = std::fabs( toVecLength - s * s );
+            }
+        }
+
+        if ( maxDistSqr < distToSegmentSqr )
+        {
+            maxDistSqr = distToSegmentSqr;
+            nVertexIndexMaxDistance = i;
+        }
+    }
+
+    return nVertexIndexMaxDistance;
+}
+
+/*
+    Appends the points to be kept for a line - all but its last one.
+    As the left part of a split line is processed first, the points
+    are found in increasing order.
+ */
+static void qwtSimplifyLine( const QPointF *p, const Line &line,
+    double toleranceSqr, QPolygonF &stripped )
+{
+    QStack<Line> stack;
+    stack.reserve( 500 );
+
+    stack.push( line );
+
+    while ( !stack.isEmpty() )
+    {
+        const Line r = stack.pop();
+
+        double maxDistSqr;
+        const int index = qwtFarthestPoint( p, r, maxDistSqr );
+
+        if ( maxDistSqr <= toleranceSqr )
+        {
+            stripped += p[r.from];
+        }
+        else
+        {
+            stack.push( Line( index, r.to ) );
+            stack.push( Line( r.from, index ) );
+        }
+    }
+}
+
+static void qwtSimplify( const QPointF *p, int numPoints,
+    double toleranceSqr, QPolygonF &stripped )
+{
+    if ( numPoints <= 0 )
+        return;
+
+    qwtSimplifyLine( p, Line( 0, numPoints - 1 ), toleranceSqr, stripped );
+
+    if ( numPoints > 1 )
+        stripped += p[numPoints - 1];
+}
+
+static QPolygonF qwtSimplifyChunks( const QPointF *p, int numPoints,
+    int chunkSize, double toleranceSqr )
+{
+    QPolygonF stripped;
+
+    for ( int i = 0; i < numPoints; i += chunkSize )
+    {
+        qwtSimplify( p + i, qMin( chunkSize, numPoints - i ),
+            toleranceSqr, stripped );
+    }
+
+    return stripped;
+}
+
+#if QWT_USE_THREADS
+
+static QPolygonF qwtSimplifiedLine( const QPointF *p,
+    Line line, double toleranceSqr )
+{
+    QPolygonF stripped;
+    qwtSimplifyLine( p, line, toleranceSqr, stripped );
+
+    return stripped;
+}
+
+static QPolygonF qwtSimplifyChunksParallel( const QPointF *p, int numPoints,
+    int chunkSize, double toleranceSqr, uint numThreads )
+{
+    // each thread processes a sequence of complete chunks
+
+    const int numChunks = ( numPoints + chunkSize - 1 ) / chunkSize;
+    numThreads = qMin( numThreads, uint( numChunks ) );
+
+    const int numThreadChunks = numChunks / numThreads;
+
+    QList< QFuture<QPolygonF> > futures;
+    for ( uint i = 0; i < numThreads - 1; i++ )
+    {
+        const int from = i * numThreadChunks * chunkSize;
+
+        futures += QtConcurrent::run( &qwtSimplifyChunks, p + from,
+            numThreadChunks * chunkSize, chunkSize, toleranceSqr );
+    }
+
+    const int from = ( numThreads - 1 ) * numThreadChunks * chunkSize;
+    const QPolygonF last = qwtSimplifyChunks( p + from,
+        numPoints - from, chunkSize, toleranceSqr );
+
+    QPolygonF stripped;
+    for ( int i = 0; i < futures.size(); i++ )
+        stripped += futures[i].result();
+
+    stripped += last;
+
+    return stripped;
+}
+
+static QPolygonF qwtSimplifyParallel( const QPointF *p, int numPoints,
+    double toleranceSqr, uint numThreads )
+{
+    /*
+        The first levels of the recursion are done in the calling
+        thread until there are enough independent lines
+        for all threads. The result is the same as when
+        running the algorithm in one thread.
+     */
+
+    const int minLineSize = 1000;
+    const int maxLines = 4 * numThreads;
+
+    QVector<Line> lines;
+    lines += Line( 0, numPoints - 1 );
+
+    // lines, that don't need to be split anymore
+    QVector<bool> isDone( 1, false );
+
+    bool isSplit = true;
+    while ( isSplit && lines.size() < maxLines )
+    {
+        isSplit = false;
+
+        QVector<Line> splitLines;
+        QVector<bool> splitDone;
+
+        for ( int i = 0; i < lines.size(); i++ )
+        {
+            const Line &line = lines[i];
+
+            if ( !isDone[i] && line.to - line.from >= minLineSize )
+            {
+                double maxDistSqr;
+                const int index = qwtFarthestPoint( p, line, maxDistSqr );
+
+                if ( maxDistSqr > toleranceSqr )
+                {
+                    splitLines += Line( line.from, index );
+                    splitLines += Line( index, line.to );
+                    splitDone += false;
+                    splitDone += false;
+
+                    isSplit = true;
+                }
+                else
+                {
+                    splitLines += line;
+                    splitDone += true;
+                }
+            }
+            else
+            {
+                splitLines += line;
+                splitDone += isDone[i];
+            }
+        }
+
+        lines = splitLines;
+        isDone = splitDone;
+    }
+
+    QVector< QFuture<QPolygonF> > futures( lines.size() );
+    for ( int i = 0; i < lines.size(); i++ )
+    {
+        if ( !isDone[i] )
+        {
+            futures[i] = QtConcurrent::run( &qwtSimplifiedLine,
+                p, lines[i], toleranceSqr );
+        }
+    }
+
+    QPolygonF stripped;
+    for ( int i = 0; i < lines.size(); i++ )
+    {
+        if ( isDone[i] )
+            stripped += p[ lines[i].from ];
+        else
+            stripped += futures[i].result();
+    }
+
+    stripped += p[numPoints - 1];
+
+    return stripped;
+}
+
+#endif
 
 class QwtWeedingCurveFitter::PrivateData
 {
 public:
     PrivateData():
         tolerance( 1.0 ),
-        chunkSize( 0 )
+        chunkSize( 0 ),
+        numThreads( 1 )
     {
     }
 
     double tolerance;
     uint chunkSize;
-};
-
-class QwtWeedingCurveFitter::Line
-{
-public:
-    Line( int i1 = 0, int i2 = 0 ):
-        from( i1 ),
-        to( i2 )
-    {
-    }
+    uint numThreads;
 
-    int from;
-    int to;
+    // for appendPoints()
+    QPolygonF fittedPoints;
+    QPolygonF pendingPoints;
 };
 
 /*!
@@ -116,6 +375,35 @@ uint QwtWeedingCurveFitter::chunkSize() const
     return d_data->chunkSize;
 }
 
+/*!
+ Set the number of threads for simplifying a polygon
+
+ When a chunk size has been set, the chunks are distributed
+ to the threads. Otherwise the first levels of the recursion are
+ done in the calling thread until there are enough independent
+ parts of the polygon, that can be processed in parallel.
+
+ In both cases the result is the same as with one thread.
+
+ \param numThreads Number of threads, 0 means the number of cores
+                   of the system. The default setting is 1.
+
+ \sa threadCount(), setChunkSize()
+*/
+void QwtWeedingCurveFitter::setThreadCount( uint numThreads )
+{
+    d_data->numThreads = numThreads;
+}
+
+/*!
+  \return Number of threads for simplifying a polygon
+  \sa setThreadCount()
+*/
+uint QwtWeedingCurveFitter::threadCount() const
+{
+    return d_data->numThreads;
+}
+
 /*!
   \param points Series of data points
   \return Curve points
@@ -126,21 +414,35 @@ QPolygonF QwtWeedingCurveFitter::fitCurve( const QPolygonF &points ) const
     if ( points.isEmpty() )
         return points;
 
-    QPolygonF fittedPoints;
-    if ( d_data->chunkSize == 0 )
-    {
-        fittedPoints = simplify( points );
-    }
-    else
+    const double toleranceSqr = d_data->tolerance * d_data->tolerance;
+    const int chunkSize = d_data->chunkSize;
+
+#if QWT_USE_THREADS
+    uint numThreads = d_data->numThreads;
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
+
+    // not worth the overhead for small polygons
+    const int minParallelSize = 10000;
+
+    if ( numThreads > 1 && points.size() >= minParallelSize )
     {
-        for ( int i = 0; i < points.size(); i += d_data->chunkSize )
+        if ( chunkSize == 0 )
         {
-            const QPolygonF p = points.mid( i, d_data->chunkSize );
-            fittedPoints += simplify( p );
+            return qwtSimplifyParallel( points.constData(),
+                points.size(), toleranceSqr, numThreads );
         }
+
+        return qwtSimplifyChunksParallel( points.constData(),
+            points.size(), chunkSize, toleranceSqr, numThreads );
     }
+#endif
+
+    if ( chunkSize == 0 )
+        return simplify( points );
 
-    return fittedPoints;
+    return qwtSimplifyChunks( points.constData(),
+        points.size(), chunkSize, toleranceSqr );
 }
 
 /*!
@@ -155,87 +457,136 @@ QPainterPath QwtWeedingCurveFitter::fitCurvePath( const QPolygonF &points ) cons
     return path;
 }
 
-QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
+/*!
+  \brief Append points to a polygon, that is simplified incrementally
+
+  The points are collected until a chunk is complete, then the chunk
+  is simplified and its result is stored. So each point is processed
+  only once, regardless of how often points are appended. The result
+  of fittedPoints() is the same as fitCurve() for all appended points.
+
+  \param points Points to be appended
+
+  \note Without a chunk size all points are kept until fittedPoints()
+        is called. Changing the tolerance or the chunk size affects
+        the points, that have not been simplified yet, only -
+        clearPoints() starts from scratch.
+
+  \sa fittedPoints(), clearPoints(), setChunkSize()
+*/
+void QwtWeedingCurveFitter::appendPoints( const QPolygonF &points )
 {
+    QPolygonF &pending = d_data->pendingPoints;
+
+    const int chunkSize = d_data->chunkSize;
+    if ( chunkSize == 0 )
+    {
+        pending += points;
+        return;
+    }
+
     const double toleranceSqr = d_data->tolerance * d_data->tolerance;
 
-    QStack<Line> stack;
-    stack.reserve( 500 );
+    if ( pending.size() >= chunkSize )
+    {
+        // the chunk size has been reduced, after the points have been collected
 
-    const QPointF *p = points.data();
-    const int nPoints = points.size();
+        const int numPending = ( pending.size() / chunkSize ) * chunkSize;
+        d_data->fittedPoints += qwtSimplifyChunks( pending.constData(),
+            numPending, chunkSize, toleranceSqr );
 
-    QVector<bool> usePoint( nPoints, false );
+        pending.remove( 0, numPending );
+    }
 
-    stack.push( Line( 0, nPoints - 1 ) );
+    int from = 0;
 
-    while ( !stack.isEmpty() )
+    if ( !pending.isEmpty() )
     {
-        const Line r = stack.pop();
+        // completing the pending chunk first
 
-        // initialize line segment
-        const double vecX = p[r.to].x() - p[r.from].x();
-        const double vecY = p[r.to].y() - p[r.from].y();
+        from = qMin( chunkSize - pending.size(), points.size() );
+        pending += points.mid( 0, from );
 
-        const double vecLength = std::sqrt( vecX * vecX + vecY * vecY );
+        if ( pending.size() < chunkSize )
+            return;
 
-        const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
-        const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+        qwtSimplify( pending.constData(), pending.size(),
+            toleranceSqr, d_data->fittedPoints );
 
-        double maxDistSqr = 0.0;
-        int nVertexIndexMaxDistance = r.from + 1;
-        for ( int i = r.from + 1; i < r.to; i++ )
-        {
-            //compare to anchor
-            const double fromVecX = p[i].x() - p[r.from].x();
-            const double fromVecY = p[i].y() - p[r.from].y();
+        pending.clear();
+    }
 
-            double distToSegmentSqr;
-            if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
-            {
-                distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
-            }
-            else
-            {
-                const double toVecX = p[i].x() - p[r.to].x();
-                const double toVecY = p[i].y() - p[r.to].y();
-                const double toVecLength = toVecX * toVecX + toVecY * toVecY;
+    const int numPoints = ( ( points.size() - from ) / chunkSize ) * chunkSize;
+    if ( numPoints > 0 )
+    {
+        const QPointF *p = points.constData() + from;
 
-                const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
-                if ( s < 0.0 )
-                {
-                    distToSegmentSqr = toVecLength;
-                }
-                else
-                {
-                    distToSegmentSqr = std::fabs( toVecLength - s * s );
-                }
-            }
+#if QWT_USE_THREADS
+        uint numThreads = d_data->numThreads;
+        if ( numThreads == 0 )
+            numThreads = QThread::idealThreadCount();
 
-            if ( maxDistSqr < distToSegmentSqr )
+        if ( numThreads > 1 && numPoints > chunkSize )
+        {
+            d_data->fittedPoints += qwtSimplifyChunksParallel(
+                p, numPoints, chunkSize, toleranceSqr, numThreads );
+        }
+        else
+#endif
+        {
+            for ( int i = 0; i < numPoints; i += chunkSize )
             {
-                maxDistSqr = distToSegmentSqr;
-                nVertexIndexMaxDistance = i;
+                qwtSimplify( p + i, chunkSize,
+                    toleranceSqr, d_data->fittedPoints );
             }
         }
-        if ( maxDistSqr <= toleranceSqr )
+    }
+
+    pending = points.mid( from + numPoints );
+}
+
+/*!
+  \return Simplified polygon of all points, that have been appended
+  \sa appendPoints(), clearPoints()
+*/
+QPolygonF QwtWeedingCurveFitter::fittedPoints() const
+{
+    QPolygonF points = d_data->fittedPoints;
+
+    const QPolygonF &pending = d_data->pendingPoints;
+    if ( !pending.isEmpty() )
+    {
+        if ( d_data->chunkSize == 0 )
         {
-            usePoint[r.from] = true;
-            usePoint[r.to] = true;
+            points += fitCurve( pending );
         }
         else
         {
-            stack.push( Line( r.from, nVertexIndexMaxDistance ) );
-            stack.push( Line( nVertexIndexMaxDistance, r.to ) );
+            // the last chunk is incomplete and has not been stored yet,
+            // unless the chunk size has been reduced in the meantime
+            points += qwtSimplifyChunks( pending.constData(), pending.size(),
+                d_data->chunkSize, d_data->tolerance * d_data->tolerance );
         }
     }
 
+    return points;
+}
+
+/*!
+  \brief Remove all points, that have been appended
+  \sa appendPoints(), fittedPoints()
+*/
+void QwtWeedingCurveFitter::clearPoints()
+{
+    d_data->fittedPoints.clear();
+    d_data->pendingPoints.clear();
+}
+
+QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
+{
     QPolygonF stripped;
-    for ( int i = 0; i < nPoints; i++ )
-    {
-        if ( usePoint[i] )
-            stripped += p[i];
-    }
+    qwtSimplify( points.constData(), points.size(),
+        d_data->tolerance * d_data->tolerance, stripped );
 
     return stripped;
 }
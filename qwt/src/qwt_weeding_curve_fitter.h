@@ -34,6 +34,11 @@
   the number of points. By adjusting the tolerance parameter according to the
   axis scales QwtSplineCurveFitter can be used to implement different
   level of details to speed up painting of curves of many points.
+
+  As the chunks are independent of each other they can be simplified
+  in parallel ( setThreadCount() ). For polygons, that grow over time,
+  appendPoints() simplifies the chunks, that have been completed, only once,
+  so that the history is not revisited, when more points are appended.
 */
 class QWT_EXPORT QwtWeedingCurveFitter: public QwtCurveFitter
 {
@@ -47,14 +52,19 @@ public:
     void setChunkSize( uint );
     uint chunkSize() const;
 
+    void setThreadCount( uint );
+    uint threadCount() const;
+
     virtual QPolygonF fitCurve( const QPolygonF & ) const QWT_OVERRIDE;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const QWT_OVERRIDE;
 
+    void appendPoints( const QPolygonF & );
+    QPolygonF fittedPoints() const;
+    void clearPoints();
+
 private:
     virtual QPolygonF simplify( const QPolygonF & ) const;
 
-    class Line;
-
     class PrivateData;
     PrivateData *d_data;
 };
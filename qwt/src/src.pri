@@ -115,6 +115,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_curve.h \
         qwt_plot_dict.h \
         qwt_plot_directpainter.h \
+        qwt_plot_profiler.h \
         qwt_plot_grid.h \
         qwt_plot_histogram.h \
         qwt_plot_item.h \
@@ -143,6 +144,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.h \
         qwt_plot_rescaler.h \
         qwt_point_mapper.h \
+        qwt_point_index.h \
         qwt_raster_data.h \
         qwt_matrix_raster_data.h \
         qwt_sampling_thread.h \
@@ -150,6 +152,8 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_series_data.h \
         qwt_series_store.h \
         qwt_point_data.h \
+        qwt_pyramid_point_data.h \
+        qwt_circular_point_data.h \
         qwt_scale_widget.h 
 
     SOURCES += \
@@ -167,6 +171,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_curve.cpp \
         qwt_plot_dict.cpp \
         qwt_plot_directpainter.cpp \
+        qwt_plot_profiler.cpp \
         qwt_plot_grid.cpp \
         qwt_plot_histogram.cpp \
         qwt_plot_item.cpp \
@@ -195,11 +200,14 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_plot_magnifier.cpp \
         qwt_plot_rescaler.cpp \
         qwt_point_mapper.cpp \
+        qwt_point_index.cpp \
         qwt_raster_data.cpp \
         qwt_matrix_raster_data.cpp \
         qwt_sampling_thread.cpp \
         qwt_series_data.cpp \
         qwt_point_data.cpp \
+        qwt_pyramid_point_data.cpp \
+        qwt_circular_point_data.cpp \
         qwt_scale_widget.cpp
 
     contains(QWT_CONFIG, QwtOpenGL) {
@@ -0,0 +1,744 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+/*
+    Benchmarks for the performance critical code paths of Qwt.
+
+    All rendering is done offscreen into a QImage. For each benchmark
+    one line is written to stdout:
+
+        group,name,iterations,msecs
+
+    where msecs is the average time of one iteration. The benchmarks
+    can be limited to specific groups by passing their names as arguments:
+
+        benchmarks curve spectrogram
+
+    Use "-platform offscreen" on systems without a display.
+ */
+
+#include <qwt_plot.h>
+#include <qwt_plot_curve.h>
+#include <qwt_plot_spectrogram.h>
+#include <qwt_plot_renderer.h>
+#include <qwt_matrix_raster_data.h>
+#include <qwt_point_mapper.h>
+#include <qwt_series_data.h>
+#include <qwt_scale_map.h>
+#include <qwt_scale_engine.h>
+#include <qwt_date_scale_engine.h>
+#include <qwt_date.h>
+#include <qwt_symbol.h>
+#include <qwt_clipper.h>
+#include <qwt_interval.h>
+#include <qwt_text.h>
+
+#include <qapplication.h>
+#include <qelapsedtimer.h>
+#include <qstringlist.h>
+#include <qimage.h>
+#include <qpainter.h>
+#include <qpolygon.h>
+#include <qvector.h>
+#include <qfont.h>
+#include <qpen.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    class Task
+    {
+    public:
+        virtual ~Task()
+        {
+        }
+
+        virtual void run() = 0;
+    };
+
+    class Benchmark
+    {
+    public:
+        Benchmark( const QStringList &groups ):
+            d_groups( groups ),
+            d_minTime( 250 )
+        {
+            std::printf( "group,name,iterations,msecs\n" );
+        }
+
+        bool isEnabled( const char *group ) const
+        {
+            return d_groups.isEmpty() || d_groups.contains( group );
+        }
+
+        void measure( const char *group, const QString &name, Task &task ) const
+        {
+            // the first run initializes lazy caches and is not measured
+            task.run();
+
+            QElapsedTimer timer;
+            timer.start();
+
+            int iterations = 0;
+            do
+            {
+                task.run();
+                iterations++;
+            }
+            while ( timer.elapsed() < d_minTime );
+
+            const double msecs = double( timer.elapsed() ) / iterations;
+
+            std::printf( "%s,%s,%d,%.4f\n", group,
+                name.toLatin1().constData(), iterations, msecs );
+            std::fflush( stdout );
+        }
+
+    private:
+        const QStringList d_groups;
+        const qint64 d_minTime;
+    };
+
+    class Canvas
+    {
+    public:
+        Canvas( int width = 1000, int height = 800 ):
+            image( width, height, QImage::Format_ARGB32_Premultiplied ),
+            rect( 0, 0, width, height )
+        {
+        }
+
+        void setScales( const QRectF &area )
+        {
+            xMap.setPaintInterval( rect.left(), rect.right() );
+            xMap.setScaleInterval( area.left(), area.right() );
+
+            yMap.setPaintInterval( rect.bottom(), rect.top() );
+            yMap.setScaleInterval( area.top(), area.bottom() );
+        }
+
+        QImage image;
+        QRectF rect;
+
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
+    };
+}
+
+static QVector<QPointF> qwtWave( int numPoints )
+{
+    // a noisy sine wave with a deterministic noise
+
+    QVector<QPointF> points( numPoints );
+
+    uint seed = 4711;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        const double noise = double( ( seed >> 16 ) & 0x7fff ) / 0x7fff - 0.5;
+
+        points[i] = QPointF( i, 1000.0 * std::sin( i * 0.0005 ) + 100.0 * noise );
+    }
+
+    return points;
+}
+
+static QVector<QPointF> qwtScatter( int numPoints, const QRectF &rect )
+{
+    QVector<QPointF> points( numPoints );
+
+    uint seed = 815;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        const double x = double( ( seed >> 16 ) & 0x7fff ) / 0x7fff;
+
+        seed = seed * 1103515245u + 12345u;
+        const double y = double( ( seed >> 16 ) & 0x7fff ) / 0x7fff;
+
+        points[i] = QPointF( rect.left() + x * rect.width(),
+            rect.top() + y * rect.height() );
+    }
+
+    return points;
+}
+
+static QwtMatrixRasterData *qwtRasterData( int numColumns, int numRows )
+{
+    QVector<double> values( numColumns * numRows );
+    for ( int row = 0; row < numRows; row++ )
+    {
+        for ( int col = 0; col < numColumns; col++ )
+        {
+            const double x = col * 0.01;
+            const double y = row * 0.01;
+
+            values[ row * numColumns + col ] = std::sin( x ) * std::cos( y )
+                + 0.2 * std::sin( 3.0 * x + 2.0 * y );
+        }
+    }
+
+    QwtMatrixRasterData *data = new QwtMatrixRasterData();
+    data->setValueMatrix( values, numColumns );
+    data->setInterval( Qt::XAxis, QwtInterval( 0.0, numColumns ) );
+    data->setInterval( Qt::YAxis, QwtInterval( 0.0, numRows ) );
+    data->setInterval( Qt::ZAxis, QwtInterval( -1.2, 1.2 ) );
+
+    return data;
+}
+
+static QList<double> qwtContourLevels( int numLevels )
+{
+    QList<double> levels;
+    for ( int i = 0; i < numLevels; i++ )
+        levels += -1.2 + ( i + 0.5 ) * 2.4 / numLevels;
+
+    return levels;
+}
+
+namespace
+{
+    class PointMapperTask: public Task
+    {
+    public:
+        enum Mode
+        {
+            PolygonF,
+            Points,
+            Image
+        };
+
+        PointMapperTask( const Canvas &canvas,
+                const QwtSeriesData<QPointF> *series, Mode mode ):
+            d_canvas( canvas ),
+            d_series( series ),
+            d_mode( mode )
+        {
+            d_mapper.setBoundingRect( canvas.rect );
+            if ( mode == Points )
+                d_mapper.setFlag( QwtPointMapper::WeedOutPoints, true );
+        }
+
+        virtual void run()
+        {
+            const int to = static_cast<int>( d_series->size() ) - 1;
+
+            switch( d_mode )
+            {
+                case PolygonF:
+                    d_mapper.toPolygonF( d_canvas.xMap, d_canvas.yMap,
+                        d_series, 0, to );
+                    break;
+
+                case Points:
+                    d_mapper.toPoints( d_canvas.xMap, d_canvas.yMap,
+                        d_series, 0, to );
+                    break;
+
+                case Image:
+                    d_mapper.toImage( d_canvas.xMap, d_canvas.yMap,
+                        d_series, 0, to, QPen( Qt::black ), false, 0 );
+                    break;
+            }
+        }
+
+    private:
+        const Canvas &d_canvas;
+        const QwtSeriesData<QPointF> *d_series;
+        const Mode d_mode;
+
+        QwtPointMapper d_mapper;
+    };
+
+    class ItemTask: public Task
+    {
+    public:
+        ItemTask( Canvas &canvas, const QwtPlotItem *item,
+                bool antialiased = false ):
+            d_canvas( canvas ),
+            d_item( item ),
+            d_antialiased( antialiased )
+        {
+        }
+
+        virtual void run()
+        {
+            d_canvas.image.fill( 0xffffffff );
+
+            QPainter painter( &d_canvas.image );
+            painter.setRenderHint( QPainter::Antialiasing, d_antialiased );
+
+            d_item->draw( &painter, d_canvas.xMap, d_canvas.yMap, d_canvas.rect );
+        }
+
+    private:
+        Canvas &d_canvas;
+        const QwtPlotItem *d_item;
+        const bool d_antialiased;
+    };
+
+    class SymbolTask: public Task
+    {
+    public:
+        SymbolTask( Canvas &canvas, const QwtSymbol *symbol,
+                const QPolygonF &points, bool toImage, uint numThreads = 1 ):
+            d_canvas( canvas ),
+            d_symbol( symbol ),
+            d_points( points ),
+            d_toImage( toImage ),
+            d_numThreads( numThreads )
+        {
+        }
+
+        virtual void run()
+        {
+            d_canvas.image.fill( 0 );
+
+            if ( d_toImage )
+            {
+                d_symbol->drawSymbols( &d_canvas.image,
+                    d_points.constData(), d_points.size(),
+                    QPainter::Antialiasing, d_numThreads );
+            }
+            else
+            {
+                QPainter painter( &d_canvas.image );
+                d_symbol->drawSymbols( &painter, d_points );
+            }
+        }
+
+    private:
+        Canvas &d_canvas;
+        const QwtSymbol *d_symbol;
+        const QPolygonF d_points;
+        const bool d_toImage;
+        const uint d_numThreads;
+    };
+
+    class ContourTask: public Task
+    {
+    public:
+        ContourTask( const QwtRasterData *data, const QSize &raster,
+                const QList<double> &levels, bool joined, uint numThreads ):
+            d_data( data ),
+            d_raster( raster ),
+            d_levels( levels ),
+            d_joined( joined ),
+            d_numThreads( numThreads )
+        {
+            const QwtInterval xInterval = data->interval( Qt::XAxis );
+            const QwtInterval yInterval = data->interval( Qt::YAxis );
+
+            d_rect = QRectF( xInterval.minValue(), yInterval.minValue(),
+                xInterval.width(), yInterval.width() );
+        }
+
+        virtual void run()
+        {
+            const QwtRasterData::ConrecFlags flags =
+                QwtRasterData::IgnoreAllVerticesOnLevel;
+
+            if ( d_joined )
+            {
+                d_data->contourPolylines( d_rect, d_raster,
+                    d_levels, flags, d_numThreads );
+            }
+            else
+            {
+                d_data->contourLines( d_rect, d_raster, d_levels, flags );
+            }
+        }
+
+    private:
+        const QwtRasterData *d_data;
+        QRectF d_rect;
+        const QSize d_raster;
+        const QList<double> d_levels;
+        const bool d_joined;
+        const uint d_numThreads;
+    };
+
+    class ClipperTask: public Task
+    {
+    public:
+        ClipperTask( const QRectF &clipRect, const QPolygonF &polygon ):
+            d_clipRect( clipRect ),
+            d_polygon( polygon )
+        {
+        }
+
+        virtual void run()
+        {
+            QPolygonF polygon = d_polygon;
+            QwtClipper::clipPolygonF( d_clipRect, polygon, false );
+        }
+
+    private:
+        const QRectF d_clipRect;
+        const QPolygonF d_polygon;
+    };
+
+    class ScaleTask: public Task
+    {
+    public:
+        ScaleTask( const QwtScaleEngine *engine, double x1, double x2 ):
+            d_engine( engine ),
+            d_x1( x1 ),
+            d_x2( x2 )
+        {
+        }
+
+        virtual void run()
+        {
+            // a single division is too fast to be measured
+
+            for ( int i = 0; i < 100; i++ )
+            {
+                const double offset = i * 1e-3 * ( d_x2 - d_x1 );
+                d_engine->divideScale( d_x1 + offset, d_x2 + offset, 10, 5 );
+            }
+        }
+
+    private:
+        const QwtScaleEngine *d_engine;
+        const double d_x1;
+        const double d_x2;
+    };
+
+    class TextTask: public Task
+    {
+    public:
+        TextTask( Canvas &canvas, const QString &text,
+                QwtText::TextFormat format ):
+            d_canvas( canvas ),
+            d_text( text ),
+            d_format( format )
+        {
+        }
+
+        virtual void run()
+        {
+            QPainter painter( &d_canvas.image );
+
+            // new QwtText objects, so that the layout is not cached
+
+            for ( int i = 0; i < 100; i++ )
+            {
+                const QwtText text( d_text.arg( i ), d_format );
+
+                const QSizeF size = text.textSize( d_font );
+                text.draw( &painter, QRectF( QPointF( 10, 10 ), size ) );
+            }
+        }
+
+    private:
+        Canvas &d_canvas;
+        const QString d_text;
+        const QwtText::TextFormat d_format;
+        const QFont d_font;
+    };
+
+    class RendererTask: public Task
+    {
+    public:
+        RendererTask( QwtPlot *plot, QImage *image ):
+            d_plot( plot ),
+            d_image( image )
+        {
+        }
+
+        virtual void run()
+        {
+            d_image->fill( 0xffffffff );
+
+            QwtPlotRenderer renderer;
+            renderer.renderTo( d_plot, *d_image );
+        }
+
+    private:
+        QwtPlot *d_plot;
+        QImage *d_image;
+    };
+}
+
+static void benchmarkPointMapper( const Benchmark &benchmark )
+{
+    const QwtPointSeriesData series( qwtWave( 1000000 ) );
+
+    Canvas canvas;
+    canvas.setScales( QRectF( 0.0, -1200.0, series.size(), 2400.0 ) );
+
+    PointMapperTask polygonTask( canvas, &series, PointMapperTask::PolygonF );
+    benchmark.measure( "mapper", "toPolygonF", polygonTask );
+
+    PointMapperTask pointsTask( canvas, &series, PointMapperTask::Points );
+    benchmark.measure( "mapper", "toPoints,WeedOutPoints", pointsTask );
+
+    PointMapperTask imageTask( canvas, &series, PointMapperTask::Image );
+    benchmark.measure( "mapper", "toImage", imageTask );
+}
+
+static void benchmarkCurve( const Benchmark &benchmark )
+{
+    const QVector<QPointF> points = qwtWave( 200000 );
+
+    Canvas canvas;
+    canvas.setScales( QRectF( 0.0, -1200.0, points.size(), 2400.0 ) );
+
+    const struct
+    {
+        QwtPlotCurve::CurveStyle style;
+        const char *name;
+    } styles[] =
+    {
+        { QwtPlotCurve::Lines, "Lines" },
+        { QwtPlotCurve::Sticks, "Sticks" },
+        { QwtPlotCurve::Steps, "Steps" },
+        { QwtPlotCurve::Dots, "Dots" }
+    };
+
+    const struct
+    {
+        int attributes;
+        const char *name;
+    } attributes[] =
+    {
+        { 0, "None" },
+        { QwtPlotCurve::ClipPolygons, "ClipPolygons" },
+        { QwtPlotCurve::FilterPoints, "FilterPoints" },
+        { QwtPlotCurve::FilterPointsAggressive, "FilterPointsAggressive" },
+        { QwtPlotCurve::MinimizeMemory, "MinimizeMemory" },
+        { QwtPlotCurve::ImageBuffer, "ImageBuffer" },
+        { QwtPlotCurve::MonotonicX, "MonotonicX" }
+    };
+
+    const int numStyles = sizeof( styles ) / sizeof( styles[0] );
+    const int numAttributes = sizeof( attributes ) / sizeof( attributes[0] );
+
+    for ( int i = 0; i < numStyles; i++ )
+    {
+        for ( int j = 0; j < numAttributes; j++ )
+        {
+            QwtPlotCurve curve;
+            curve.setSamples( points );
+            curve.setStyle( styles[i].style );
+
+            // the default setting of ClipPolygons is on
+            curve.setPaintAttribute( QwtPlotCurve::ClipPolygons, false );
+            curve.setPaintAttribute( static_cast<QwtPlotCurve::PaintAttribute>(
+                attributes[j].attributes ), true );
+
+            ItemTask task( canvas, &curve );
+
+            const QString name = QString( "%1,%2" )
+                .arg( styles[i].name ).arg( attributes[j].name );
+            benchmark.measure( "curve", name, task );
+        }
+    }
+
+    QwtPlotCurve fittedCurve;
+    fittedCurve.setSamples( points.mid( 0, 20000 ) );
+    fittedCurve.setCurveAttribute( QwtPlotCurve::Fitted, true );
+
+    ItemTask fittedTask( canvas, &fittedCurve, true );
+    benchmark.measure( "curve", "Lines,Fitted", fittedTask );
+}
+
+static void benchmarkSymbols( const Benchmark &benchmark )
+{
+    Canvas canvas;
+    const QPolygonF points = qwtScatter( 200000, canvas.rect );
+
+    const struct
+    {
+        QwtSymbol::CachePolicy policy;
+        const char *name;
+    } policies[] =
+    {
+        { QwtSymbol::NoCache, "NoCache" },
+        { QwtSymbol::Cache, "Cache" },
+        { QwtSymbol::AutoCache, "AutoCache" }
+    };
+
+    const int numPolicies = sizeof( policies ) / sizeof( policies[0] );
+
+    for ( int i = 0; i < numPolicies; i++ )
+    {
+        QwtSymbol symbol( QwtSymbol::Ellipse,
+            QBrush( Qt::yellow ), QPen( Qt::blue ), QSize( 7, 7 ) );
+        symbol.setCachePolicy( policies[i].policy );
+
+        SymbolTask task( canvas, &symbol, points, false );
+        benchmark.measure( "symbol", policies[i].name, task );
+    }
+
+    const uint threadCounts[] = { 1, 0 };
+    for ( int i = 0; i < 2; i++ )
+    {
+        QwtSymbol symbol( QwtSymbol::Ellipse,
+            QBrush( Qt::yellow ), QPen( Qt::blue ), QSize( 7, 7 ) );
+
+        SymbolTask task( canvas, &symbol, points, true, threadCounts[i] );
+        benchmark.measure( "symbol",
+            QString( "Image,threads=%1" ).arg( threadCounts[i] ), task );
+    }
+}
+
+static void benchmarkSpectrogram( const Benchmark &benchmark )
+{
+    Canvas canvas;
+    canvas.setScales( QRectF( 0.0, 0.0, 1000.0, 1000.0 ) );
+
+    const uint threadCounts[] = { 1, 2, 4, 0 };
+    for ( int i = 0; i < 4; i++ )
+    {
+        QwtPlotSpectrogram spectrogram;
+        spectrogram.setData( qwtRasterData( 1000, 1000 ) );
+        spectrogram.setRenderThreadCount( threadCounts[i] );
+
+        ItemTask task( canvas, &spectrogram );
+        benchmark.measure( "spectrogram",
+            QString( "Image,threads=%1" ).arg( threadCounts[i] ), task );
+    }
+
+    QwtPlotSpectrogram spectrogram;
+    spectrogram.setData( qwtRasterData( 1000, 1000 ) );
+    spectrogram.setDisplayMode( QwtPlotSpectrogram::ImageMode, false );
+    spectrogram.setDisplayMode( QwtPlotSpectrogram::ContourMode, true );
+    spectrogram.setContourLevels( qwtContourLevels( 30 ) );
+    spectrogram.setRenderThreadCount( 0 );
+
+    ItemTask task( canvas, &spectrogram );
+    benchmark.measure( "spectrogram", "Contours", task );
+}
+
+static void benchmarkContours( const Benchmark &benchmark )
+{
+    const QwtMatrixRasterData *data = qwtRasterData( 2000, 2000 );
+
+    const QSize raster( 1000, 1000 );
+    const QList<double> levels = qwtContourLevels( 30 );
+
+    ContourTask linesTask( data, raster, levels, false, 1 );
+    benchmark.measure( "contour", "contourLines", linesTask );
+
+    const uint threadCounts[] = { 1, 2, 4, 0 };
+    for ( int i = 0; i < 4; i++ )
+    {
+        ContourTask task( data, raster, levels, true, threadCounts[i] );
+        benchmark.measure( "contour",
+            QString( "contourPolylines,threads=%1" ).arg( threadCounts[i] ), task );
+    }
+
+    delete data;
+}
+
+static void benchmarkClipper( const Benchmark &benchmark )
+{
+    const QVector<QPointF> points = qwtWave( 1000000 );
+
+    // the wave leaves and enters the clip rectangle frequently
+    const QRectF clipRect( 0.0, -800.0, 0.5 * points.size(), 1600.0 );
+
+    ClipperTask task( clipRect, points );
+    benchmark.measure( "clipper", "clipPolygonF", task );
+}
+
+static void benchmarkScales( const Benchmark &benchmark )
+{
+    const QwtLinearScaleEngine linearEngine;
+    ScaleTask linearTask( &linearEngine, -12.345, 1234.5 );
+    benchmark.measure( "scale", "Linear", linearTask );
+
+    const QwtLogScaleEngine logEngine;
+    ScaleTask logTask( &logEngine, 1.0, 1e6 );
+    benchmark.measure( "scale", "Log", logTask );
+
+    const QDateTime from( QDate( 2020, 1, 1 ), QTime( 0, 0 ), Qt::UTC );
+
+    const QwtDateScaleEngine dateEngine( Qt::UTC );
+
+    ScaleTask hoursTask( &dateEngine, QwtDate::toDouble( from ),
+        QwtDate::toDouble( from.addSecs( 36 * 3600 ) ) );
+    benchmark.measure( "scale", "Date,Hours", hoursTask );
+
+    ScaleTask yearsTask( &dateEngine, QwtDate::toDouble( from ),
+        QwtDate::toDouble( from.addYears( 3 ) ) );
+    benchmark.measure( "scale", "Date,Years", yearsTask );
+}
+
+static void benchmarkText( const Benchmark &benchmark )
+{
+    Canvas canvas( 400, 100 );
+
+    TextTask plainTask( canvas, "Tick label %1", QwtText::PlainText );
+    benchmark.measure( "text", "PlainText", plainTask );
+
+    TextTask richTask( canvas, "<b>x</b><sup>%1</sup> + y<sub>2</sub>",
+        QwtText::RichText );
+    benchmark.measure( "text", "RichText", richTask );
+}
+
+static void benchmarkPlot( const Benchmark &benchmark )
+{
+    QwtPlot plot;
+    plot.setTitle( "Benchmark" );
+    plot.setAxisScale( QwtPlot::xBottom, 0.0, 100000.0 );
+    plot.setAxisScale( QwtPlot::yLeft, -1200.0, 1200.0 );
+
+    QwtPlotCurve *curve = new QwtPlotCurve();
+    curve->setSamples( qwtWave( 100000 ) );
+    curve->attach( &plot );
+
+    QImage image( 1000, 800, QImage::Format_ARGB32_Premultiplied );
+
+    RendererTask task( &plot, &image );
+    benchmark.measure( "plot", "QwtPlotRenderer", task );
+}
+
+int main( int argc, char *argv[] )
+{
+    QApplication app( argc, argv );
+
+    QStringList groups = app.arguments();
+    groups.removeFirst();
+
+    const Benchmark benchmark( groups );
+
+    if ( benchmark.isEnabled( "mapper" ) )
+        benchmarkPointMapper( benchmark );
+
+    if ( benchmark.isEnabled( "curve" ) )
+        benchmarkCurve( benchmark );
+
+    if ( benchmark.isEnabled( "symbol" ) )
+        benchmarkSymbols( benchmark );
+
+    if ( benchmark.isEnabled( "spectrogram" ) )
+        benchmarkSpectrogram( benchmark );
+
+    if ( benchmark.isEnabled( "contour" ) )
+        benchmarkContours( benchmark );
+
+    if ( benchmark.isEnabled( "clipper" ) )
+        benchmarkClipper( benchmark );
+
+    if ( benchmark.isEnabled( "scale" ) )
+        benchmarkScales( benchmark );
+
+    if ( benchmark.isEnabled( "text" ) )
+        benchmarkText( benchmark );
+
+    if ( benchmark.isEnabled( "plot" ) )
+        benchmarkPlot( benchmark );
+
+    return 0;
+}
@@ -13,4 +13,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     splinetest \
-    splineprof
+    splineprof \
+    benchmarks